@@ -0,0 +1,97 @@
+/*
+ * ConnectionManagerBench.cpp
+ * 
+ * Measures CPU time and heap allocations of ConnectionManager's full dispatch 
+ * and fan-out path over a LoopbackTransport, with no network involved.
+ * 
+ * Usage: ConnectionManagerBench [CLIENTS] [COMMANDS]
+ */
+
+#include "../src/utils/ConnectionManager.hpp"
+#include "../src/utils/CountAPI.hpp"
+#include "../src/utils/LoopbackTransport.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+
+//Every heap allocation in the process goes through here so runs can report allocations per command
+static size_t g_allocationCount = 0;
+
+void* operator new(size_t size) {
+	g_allocationCount++;
+	void* pMemory = malloc(size == 0 ? 1 : size);
+	if(pMemory == NULL) {
+		throw std::bad_alloc();
+	}
+	return pMemory;
+}
+
+void operator delete(void* pMemory) noexcept {
+	free(pMemory);
+}
+
+void operator delete(void* pMemory, size_t) noexcept {
+	free(pMemory);
+}
+
+/**
+ * Sends 'commands' copies of 'command' from one client, each followed by one 
+ * server loop pass, and prints per-command cost.
+ * 
+ * @param deltasPerCommand number of logical increments one command carries.
+ */
+static void runScenario(const std::string& name, int clients, int commands, const std::string& command, int deltasPerCommand) {
+	std::shared_ptr<linuxservice::LoopbackTransport> pTransport(new linuxservice::LoopbackTransport());
+	pTransport->setDiscardOutput(true);
+	linuxservice::ConnectionManager manager(pTransport, std::shared_ptr<linuxservice::API>(new linuxservice::CountAPI()));
+	manager.setMaxConnections(clients);
+
+	//ConnectionManager logs every event to stdout; keep that out of the measurement
+	std::ostringstream discarded;
+	std::streambuf* pStdout = std::cout.rdbuf(discarded.rdbuf());
+
+	int sender = -1;
+	for(int i = 0; i < clients; i++) {
+		int client = pTransport->connectClient();
+		if(sender < 0) {
+			sender = client;
+		}
+	}
+	while(manager.getConnectionCount() < (size_t)clients) {
+		manager.handleConnections();
+		discarded.str("");
+	}
+
+	size_t bytesBefore = pTransport->getBytesSent();
+	size_t allocationsBefore = g_allocationCount;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(int i = 0; i < commands; i++) {
+		pTransport->clientSend(sender, command);
+		manager.handleConnections();
+		discarded.str("");
+	}
+	double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	size_t allocations = g_allocationCount - allocationsBefore;
+	size_t bytes = pTransport->getBytesSent() - bytesBefore;
+
+	std::cout.rdbuf(pStdout);
+	std::cout << name << ": " << clients << " clients, " << commands << " commands" << std::endl
+		<< "  ns/command:        " << elapsedNs / commands << std::endl
+		<< "  ns/increment:      " << elapsedNs / ((double)commands * deltasPerCommand) << std::endl
+		<< "  allocs/command:    " << (double)allocations / commands << std::endl
+		<< "  bytes out/command: " << (double)bytes / commands << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+	int clients = (argc > 1) ? std::atoi(argv[1]) : 10000;
+	int commands = (argc > 2) ? std::atoi(argv[2]) : 200;
+
+	runScenario("INCR", clients, commands, "INCR 1\r\n", 1);
+	runScenario("BATCH x10", clients, commands, "BATCH INCR 1 INCR 1 INCR 1 INCR 1 INCR 1 INCR 1 INCR 1 INCR 1 INCR 1 INCR 1\r\n", 10);
+	runScenario("OUTPUT", clients, commands, "OUTPUT\r\n", 1);
+	return 0;
+}
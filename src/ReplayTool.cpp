@@ -0,0 +1,413 @@
+/*
+ * ReplayTool.cpp
+ * 
+ * Re-drives a capture written by SingleCurrentCtLinuxService's capture mode
+ * against a running server and reports reply latency percentiles.
+ * 
+ * Usage: replay <HOST> <PORT> <CAPTURE_FILE> [--fast]
+ * By default every accept, read and close is replayed at its original time,
+ * whether or not earlier commands have been answered, and latency is measured
+ * from that scheduled time, so time spent behind schedule counts as latency.
+ * '--fast' instead has each connection send its next read as soon as its
+ * previous one has been answered, with all connections running at once.
+ * 
+ * Note: One connection is opened per connection id in the capture, including
+ * connections that only listened. All connections are driven from one poll()
+ * loop that reads every socket continuously, so broadcasts never back up on a
+ * quiet connection. Every complete line the server reads gets exactly one
+ * reply line on the sending connection: INCR, DECR and BATCH through the
+ * broadcast every connection receives, anything else directly. A broadcast
+ * is matched to the sender's command by its text up to "(Current Count", so
+ * an identical command from another connection answered first can be taken
+ * for it.
+ */
+
+#include "utils/CountAPI.hpp"
+#include "utils/TrafficCapture.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef std::chrono::steady_clock Clock;
+
+static const int kReplyTimeoutMs = 5000;
+static const size_t kServerMaxLineLength = 1024; //AsyncSocket rejects longer lines with one reply
+static const std::string kBroadcastCountMarker = "(Current Count";
+
+/**
+ * One reply the server owes a replay connection.
+ */
+struct PendingReply {
+	Clock::time_point sentAt; //scheduled send time, or actual send time with '--fast'
+	bool broadcast; //answered by a broadcast rather than a direct reply
+	std::string broadcastPrefix; //text a matching broadcast starts with
+};
+
+/**
+ * State of one replayed connection.
+ */
+struct ReplayConnection {
+	int socketDescriptor; //-1 until opened and once closed
+	bool opened; //opened at some point; a dropped connection is not reopened
+	bool greeted; //the server's greeting has arrived
+	bool closeRequested; //captured close reached; closes once nothing is owed
+	bool discardingLine; //inside an overlong line the server has already rejected
+	std::string lineSoFar; //sent bytes since the last complete line
+	std::string received; //read bytes since the last complete line
+	std::string outbound; //captured bytes the socket has not taken yet
+	std::deque<PendingReply> pending; //replies owed, oldest first
+	std::deque<size_t> queuedRecords; //with '--fast', this connection's records not yet replayed
+};
+
+/**
+ * Opens a non-blocking TCP connection to host:port.
+ * 
+ * @return int socket descriptor, -1 for failure.
+ */
+static int connectToServer(const char* host, const char* port) {
+	struct addrinfo hints;
+	struct addrinfo* pResult;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	if(getaddrinfo(host, port, &hints, &pResult) != 0) {
+		std::cerr << "Could not resolve " << host << ":" << port << std::endl;
+		return -1;
+	}
+	int socketDescriptor = socket(pResult->ai_family, pResult->ai_socktype, pResult->ai_protocol);
+	if(socketDescriptor >= 0 && (connect(socketDescriptor, pResult->ai_addr, pResult->ai_addrlen) < 0
+		|| fcntl(socketDescriptor, F_SETFL, fcntl(socketDescriptor, F_GETFL, 0) | O_NONBLOCK) < 0)) {
+		std::cerr << "Connect Failed: " << strerror(errno) << std::endl;
+		close(socketDescriptor);
+		socketDescriptor = -1;
+	}
+	freeaddrinfo(pResult);
+	return socketDescriptor;
+}
+
+/**
+ * Records the reply owed for one complete (or rejected overlong) command line,
+ * using a local CountAPI to tell broadcast commands from direct ones.
+ */
+static void expectReply(ReplayConnection& connection, const std::string& line, bool rejected,
+	linuxservice::CountAPI& predictor, Clock::time_point sentAt) {
+	PendingReply reply;
+	reply.sentAt = sentAt;
+	reply.broadcast = false;
+	if(!rejected) {
+		std::string rawInput = line;
+		std::string output;
+		linuxservice::CountAPI::InputCommand command = predictor.handleInCommand(rawInput, output);
+		if(command == linuxservice::CountAPI::INCR || command == linuxservice::CountAPI::DECR
+			|| command == linuxservice::CountAPI::BATCH) {
+			reply.broadcast = true;
+			reply.broadcastPrefix = output.substr(0, output.find(kBroadcastCountMarker));
+		}
+	}
+	connection.pending.push_back(reply);
+}
+
+/**
+ * Queues captured bytes for sending and works out how many replies they are
+ * owed, splitting lines the way the server's AsyncSocket does.
+ */
+static void queueCapturedData(ReplayConnection& connection, const std::string& data,
+	linuxservice::CountAPI& predictor, Clock::time_point sentAt) {
+	connection.outbound += data;
+	size_t start = 0;
+	while(start < data.size()) {
+		size_t end = data.find('\n', start);
+		size_t stop = (end == std::string::npos) ? data.size() : end + 1;
+		if(!connection.discardingLine) {
+			connection.lineSoFar.append(data, start, stop - start);
+		}
+		start = stop;
+		if(end == std::string::npos) {
+			if(!connection.discardingLine && connection.lineSoFar.size() >= kServerMaxLineLength) {
+				expectReply(connection, connection.lineSoFar, true, predictor, sentAt);
+				connection.lineSoFar.clear();
+				connection.discardingLine = true;
+			}
+			break;
+		}
+		if(connection.discardingLine) {
+			connection.discardingLine = false;
+		} else {
+			expectReply(connection, connection.lineSoFar, connection.lineSoFar.size() > kServerMaxLineLength,
+				predictor, sentAt);
+		}
+		connection.lineSoFar.clear();
+	}
+}
+
+/**
+ * Matches one line read from the server against the oldest reply owed on its
+ * connection. Lines that answer nothing owed (greetings, other connections'
+ * broadcasts) are skipped.
+ */
+static void handleReplyLine(ReplayConnection& connection, const std::string& line,
+	std::vector<double>& latenciesUs) {
+	if(!connection.greeted) {
+		connection.greeted = true;
+		return;
+	}
+	if(connection.pending.empty()) {
+		return;
+	}
+	const PendingReply& owed = connection.pending.front();
+	bool lineIsBroadcast = line.find(kBroadcastCountMarker) != std::string::npos;
+	if(owed.broadcast ? line.compare(0, owed.broadcastPrefix.size(), owed.broadcastPrefix) != 0 : lineIsBroadcast) {
+		return;
+	}
+	latenciesUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - owed.sentAt).count());
+	connection.pending.pop_front();
+}
+
+/**
+ * Replays one captured record on its connection: opens it on its first record, 
+ * queues data for sending, or marks it to close once it is owed nothing.
+ * 
+ * @return bool false if the connection could not be opened.
+ */
+static bool issueRecord(ReplayConnection& connection, const linuxservice::TrafficCapture::Record& record, 
+	const char* host, const char* port, linuxservice::CountAPI& predictor, Clock::time_point sentAt, int& failures) {
+	if(record.type == linuxservice::TrafficCapture::CLOSE) {
+		connection.closeRequested = true;
+		return true;
+	}
+	if(!connection.opened) {
+		if((connection.socketDescriptor = connectToServer(host, port)) < 0) {
+			return false;
+		}
+		connection.opened = true;
+	}
+	if(record.type == linuxservice::TrafficCapture::DATA) {
+		if(connection.socketDescriptor < 0) {
+			failures++; //the server already dropped this connection
+		} else {
+			queueCapturedData(connection, record.data, predictor, sentAt);
+		}
+	}
+	return true;
+}
+
+/**
+ * @return Clock::time_point when a record is due with original timing.
+ */
+static Clock::time_point dueTime(Clock::time_point replayStart, const std::vector<linuxservice::TrafficCapture::Record>& records, 
+	size_t index) {
+	return replayStart + std::chrono::nanoseconds(records[index].timestampNs - records[0].timestampNs);
+}
+
+/**
+ * @return double latency at the given percentile of an ascending sorted list.
+ */
+static double percentile(const std::vector<double>& sortedLatencies, double pct) {
+	size_t index = static_cast<size_t>(pct / 100.0 * (sortedLatencies.size() - 1) + 0.5);
+	return sortedLatencies[index];
+}
+
+int main(int argc, char const *argv[]) {
+	if(argc < 4 || argc > 5 || (argc == 5 && std::string(argv[4]) != "--fast")) {
+		std::cerr << "Usage: replay <HOST> <PORT> <CAPTURE_FILE> [--fast]" << std::endl;
+		return 1;
+	}
+	bool originalTiming = (argc == 4);
+
+	std::vector<linuxservice::TrafficCapture::Record> records;
+	if(!linuxservice::TrafficCapture::readCapture(argv[3], records)) {
+		return 1;
+	}
+	if(records.empty()) {
+		std::cerr << "Capture contains no records." << std::endl;
+		return 1;
+	}
+
+	//One connection per captured connection id, including ones that only listened
+	std::map<uint32_t, size_t> connectionIndexes;
+	std::vector<ReplayConnection> connections;
+	for(size_t i = 0; i < records.size(); i++) {
+		if(connectionIndexes.count(records[i].connectionId) == 0) {
+			connectionIndexes[records[i].connectionId] = connections.size();
+			ReplayConnection connection;
+			connection.socketDescriptor = -1;
+			connection.opened = false;
+			connection.greeted = false;
+			connection.closeRequested = false;
+			connection.discardingLine = false;
+			connections.push_back(connection);
+		}
+		if(!originalTiming) {
+			connections[connectionIndexes[records[i].connectionId]].queuedRecords.push_back(i);
+		}
+	}
+	std::cout << "Replaying " << records.size() << " records over " << connections.size()
+		<< " connections (" << (originalTiming ? "original timing" : "as fast as possible") << ")" << std::endl;
+
+	linuxservice::CountAPI predictor;
+	std::vector<double> latenciesUs;
+	latenciesUs.reserve(records.size());
+	int failures = 0;
+	size_t nextRecord = 0; //original timing only: next record due
+	std::vector<struct pollfd> pollDescriptors;
+	std::vector<size_t> pollConnections; //connection index of each pollDescriptors entry
+	Clock::time_point replayStart = Clock::now();
+	Clock::time_point lastProgress = replayStart;
+	while(true) {
+		Clock::time_point now = Clock::now();
+
+		//Issue whatever is due: by capture time, or per connection once it is owed nothing
+		bool recordsLeft;
+		if(originalTiming) {
+			while(nextRecord < records.size() && dueTime(replayStart, records, nextRecord) <= now) {
+				const linuxservice::TrafficCapture::Record& record = records[nextRecord];
+				if(!issueRecord(connections[connectionIndexes[record.connectionId]], record, argv[1], argv[2], 
+					predictor, dueTime(replayStart, records, nextRecord), failures)) {
+					std::cerr << "Could not open replay connection " << record.connectionId << std::endl;
+					return 1;
+				}
+				nextRecord++;
+			}
+			recordsLeft = nextRecord < records.size();
+		} else {
+			recordsLeft = false;
+			for(size_t c = 0; c < connections.size(); c++) {
+				ReplayConnection& connection = connections[c];
+				while(!connection.queuedRecords.empty()) {
+					const linuxservice::TrafficCapture::Record& record = records[connection.queuedRecords.front()];
+					bool answered = connection.greeted && connection.pending.empty() && connection.outbound.empty();
+					if(record.type != linuxservice::TrafficCapture::ACCEPT && connection.socketDescriptor >= 0 && !answered) {
+						break;
+					}
+					connection.queuedRecords.pop_front();
+					if(!issueRecord(connection, record, argv[1], argv[2], predictor, now, failures)) {
+						std::cerr << "Could not open replay connection " << record.connectionId << std::endl;
+						return 1;
+					}
+				}
+				recordsLeft = recordsLeft || !connection.queuedRecords.empty();
+			}
+		}
+
+		//Send, close and poll every open connection
+		bool owed = false;
+		pollDescriptors.clear();
+		pollConnections.clear();
+		for(size_t c = 0; c < connections.size(); c++) {
+			ReplayConnection& connection = connections[c];
+			if(connection.socketDescriptor < 0) {
+				continue;
+			}
+			while(!connection.outbound.empty()) {
+				ssize_t sendReturn = send(connection.socketDescriptor, connection.outbound.data(), 
+					connection.outbound.size(), MSG_NOSIGNAL);
+				if(sendReturn < 0) {
+					break;
+				}
+				connection.outbound.erase(0, sendReturn);
+			}
+			if(connection.closeRequested && connection.pending.empty() && connection.outbound.empty()) {
+				close(connection.socketDescriptor);
+				connection.socketDescriptor = -1;
+				continue;
+			}
+			owed = owed || !connection.pending.empty() || !connection.outbound.empty();
+			struct pollfd entry;
+			entry.fd = connection.socketDescriptor;
+			entry.events = POLLIN | (connection.outbound.empty() ? 0 : POLLOUT);
+			entry.revents = 0;
+			pollDescriptors.push_back(entry);
+			pollConnections.push_back(c);
+		}
+		if(!recordsLeft && !owed) {
+			break;
+		}
+		if(!owed) {
+			lastProgress = now; //an idle stretch of the capture is not a missing reply
+		} else if(std::chrono::duration_cast<std::chrono::milliseconds>(now - lastProgress).count() > kReplyTimeoutMs) {
+			std::cerr << "No reply for " << kReplyTimeoutMs << " ms; giving up on what is still owed." << std::endl;
+			break;
+		}
+
+		//Sleep until something is readable or writable, or the next record is due
+		struct timespec timeout = {kReplyTimeoutMs / 1000, 0};
+		if(originalTiming && nextRecord < records.size()) {
+			Clock::duration untilDue = dueTime(replayStart, records, nextRecord) - Clock::now();
+			long long untilDueNs = std::max<long long>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(untilDue).count());
+			timeout.tv_sec = untilDueNs / 1000000000;
+			timeout.tv_nsec = untilDueNs % 1000000000;
+		}
+		if(ppoll(pollDescriptors.data(), pollDescriptors.size(), &timeout, NULL) < 0 && errno != EINTR) {
+			std::cerr << "Replay poll() failed: " << strerror(errno) << std::endl;
+			return 1;
+		}
+
+		//Read every readable connection, matching complete lines to replies owed
+		char buffer[4096];
+		for(size_t p = 0; p < pollDescriptors.size(); p++) {
+			if((pollDescriptors[p].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+				continue;
+			}
+			ReplayConnection& connection = connections[pollConnections[p]];
+			ssize_t readReturn;
+			while((readReturn = read(connection.socketDescriptor, buffer, sizeof(buffer))) > 0) {
+				connection.received.append(buffer, readReturn);
+			}
+			size_t start = 0;
+			size_t end;
+			size_t owedBefore = connection.pending.size();
+			while((end = connection.received.find('\n', start)) != std::string::npos) {
+				handleReplyLine(connection, connection.received.substr(start, end + 1 - start), latenciesUs);
+				start = end + 1;
+			}
+			connection.received.erase(0, start);
+			if(connection.pending.size() != owedBefore) {
+				lastProgress = Clock::now();
+			}
+			if(readReturn == 0 || (readReturn < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+				//the server dropped this connection; whatever it still owed will not arrive
+				failures += connection.pending.size();
+				connection.pending.clear();
+				connection.outbound.clear();
+				close(connection.socketDescriptor);
+				connection.socketDescriptor = -1;
+			}
+		}
+	}
+	double elapsedSec = std::chrono::duration<double>(Clock::now() - replayStart).count();
+
+	for(size_t c = 0; c < connections.size(); c++) {
+		failures += connections[c].pending.size();
+		if(connections[c].socketDescriptor >= 0) {
+			close(connections[c].socketDescriptor);
+		}
+	}
+
+	std::cout << "Replied: " << latenciesUs.size() << "  Failed: " << failures
+		<< "  Elapsed: " << elapsedSec << " s" << std::endl;
+	if(latenciesUs.empty()) {
+		return 1;
+	}
+	std::sort(latenciesUs.begin(), latenciesUs.end());
+	std::cout << "Latency (us)  p50: " << percentile(latenciesUs, 50)
+		<< "  p90: " << percentile(latenciesUs, 90)
+		<< "  p99: " << percentile(latenciesUs, 99)
+		<< "  p99.9: " << percentile(latenciesUs, 99.9)
+		<< "  max: " << latenciesUs.back() << std::endl;
+	return failures == 0 ? 0 : 1;
+}
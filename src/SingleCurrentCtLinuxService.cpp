@@ -3,51 +3,82 @@
  * 
  * Establishes a TCP server on the passed port and accepts 'count' commands 
  * defined by a third party specification.
+ * 
+ * Usage: SingleCurrentCtLinuxService <PORT> [CAPTURE_FILE] [--config FILE] [--key=value ...]
+ * Passing CAPTURE_FILE records all inbound commands for later use with 'replay'.
+ * Tuning settings (wait strategy, CPU affinity, socket options, limits) are 
+ * listed by ServerConfig::getUsage().
  */
 
 #include "utils/TCPServer.hpp"
 #include "utils/CountAPI.hpp"
 #include "utils/ConnectionManager.hpp"
+#include "utils/EventLoop.hpp"
+#include "utils/ProcessTuning.hpp"
+#include "utils/ServerConfig.hpp"
+#include "utils/TrafficCapture.hpp"
 
 #include <iostream>
+#include <csignal>
 
-bool noSIGTERM = true;
+volatile sig_atomic_t noSIGTERM = 1;
 
 void signalHandler(int signal) {
 	std::cout << "Received signal: " << signal << std::endl;
-	noSIGTERM = false;
+	noSIGTERM = 0;
 }
 
 int main(int argc, char const *argv[]) { 
 	//Installs my custom SIGTERM signal handling
     signal(SIGTERM, signalHandler);
+	//A client dropping mid-broadcast should fail that send(), not kill the server
+	signal(SIGPIPE, SIG_IGN);
 
-	int port;
-
-	//Get port value from argv
-	if(argc != 2){
-		std::cerr << "No 'port' argument provided." << std::endl;
+	//Get port and tuning values from argv and any config file
+	linuxservice::ServerConfig config;
+	if(!config.parseArgs(argc, argv)){
+		std::cerr << linuxservice::ServerConfig::getUsage();
 		return 0;
-	} else {
-		try { port = std::stoi(argv[1]); } 
-		catch (const std::exception& e) {
-			std::cerr << "Port value is an integer. " << e.what() << std::endl;
+	}
+
+	//Optional capture mode for recording traffic to replay against other builds. Started before 
+	//pinning so its writer thread keeps the full CPU mask instead of sharing the server's CPU
+	std::shared_ptr<linuxservice::TrafficCapture> pCapture;
+	if(!config.captureFile.empty()){
+		pCapture.reset(new linuxservice::TrafficCapture(config.captureFile));
+		if(!pCapture->isOpen()){
 			return 0;
 		}
 	}
 
-	std::shared_ptr<linuxservice::TCPServer> pServerSocket(new linuxservice::TCPServer(port));
+	//Startup tuning: pin first so locked and pre-faulted memory is local to the server's CPU
+	if(config.cpuAffinity >= 0 && linuxservice::ProcessTuning::pinCurrentThreadToCpu(config.cpuAffinity)){
+		std::cout << "Pinned to CPU " << config.cpuAffinity << std::endl;
+	}
+	if(config.lockMemory && linuxservice::ProcessTuning::lockAllMemory()){
+		std::cout << "Locked memory" << std::endl;
+	}
+	if(config.prefaultBytes > 0){
+		linuxservice::ProcessTuning::prefaultMemory(config.prefaultBytes);
+	}
+
+	std::shared_ptr<linuxservice::TCPServer> pServerSocket(new linuxservice::TCPServer(config));
 	std::shared_ptr<linuxservice::API> pCountApi(new linuxservice::CountAPI());
 	linuxservice::ConnectionManager connectionManager(pServerSocket, pCountApi);
+	connectionManager.setMaxConnections(config.maxConnections);
 
-	//Begins server loop for accepting new connections and handling active connections
-	while(noSIGTERM){
-		connectionManager.handleConnections();
+	if(pCapture){
+		connectionManager.setTrafficCapture(pCapture);
+		std::cout << "Capturing inbound commands to " << config.captureFile << std::endl;
 	}
 
+	//Begins server loop for accepting new connections and handling active connections
+	linuxservice::EventLoop eventLoop(connectionManager, config.waitStrategy, config.spinPasses);
+	eventLoop.run(noSIGTERM);
+
 	std::cout << "Shutting down all connections..." << std::endl;
 	connectionManager.shutdownAllConnections();
     
 	std::cout << "Exit main()" << std::endl; //TO REMOVE: here to help me keep track of my SIGTERM handling for now
     return 0; 
-} 
\ No newline at end of file
+} 
@@ -0,0 +1,272 @@
+#include "AsyncSocket.hpp"
+
+#include <errno.h>
+#include <string.h>
+
+namespace linuxservice {
+
+/**
+ * Only constructor for AsyncSocket.
+ * 
+ * @param pTransport Transport used to send queued output; must outlive the socket.
+ * @param descriptor int that identifies the accepted client.
+ */
+AsyncSocket::AsyncSocket(Transport* pTransport, int descriptor) {
+    m_pTransport = pTransport;
+    m_descriptor = descriptor;
+    m_outboundSent = 0;
+    m_closed = false;
+    m_waitingForRead = false;
+    m_discardingLine = false;
+}
+
+/**
+ * co_await socket.read_line(line) completes with true and the next line 
+ * (including its "\n") in 'line', or with false once the client has gone.
+ */
+AsyncSocket::ReadLineAwaiter AsyncSocket::read_line(std::string& line) {
+    return ReadLineAwaiter(*this, line);
+}
+
+/**
+ * co_await socket.write(data) queues data and completes once all queued 
+ * output has been sent: true on success, false once the client has gone.
+ */
+AsyncSocket::WriteAwaiter AsyncSocket::write(const std::string& data) {
+    return WriteAwaiter(*this, data);
+}
+
+int AsyncSocket::getDescriptor() {
+    return m_descriptor;
+}
+
+/**
+ * @return bool true while the handler is suspended waiting for a line.
+ */
+bool AsyncSocket::isWaitingForRead() {
+    return m_waiting && m_waitingForRead;
+}
+
+/**
+ * @return bool true while the handler is suspended until queued output is sent.
+ */
+bool AsyncSocket::isWaitingForWrite() {
+    return m_waiting && !m_waitingForRead;
+}
+
+/**
+ * Appends bytes read from the client for read_line() to split.
+ */
+void AsyncSocket::receive(const char* data, size_t length) {
+    if(m_discardingLine) {
+        //still inside a rejected overlong line
+        const char* end = static_cast<const char*>(memchr(data, '\n', length));
+        if(end == nullptr) {
+            return;
+        }
+        m_discardingLine = false;
+        length -= end + 1 - data;
+        data = end + 1;
+    }
+    m_inbound.append(data, length);
+}
+
+/**
+ * Records that the client has gone; pending and future awaits complete with false.
+ */
+void AsyncSocket::markClosed() {
+    m_closed = true;
+}
+
+bool AsyncSocket::isClosed() {
+    return m_closed;
+}
+
+/**
+ * Queues output without waiting for it to be sent, e.g. for broadcasts. 
+ * Anything the transport does not take now is sent by later flush() calls.
+ * 
+ * @return bool true if data went out in full straight away, so the socket's 
+ * state is unchanged; false if any of it was queued or the client has gone.
+ */
+bool AsyncSocket::queue(const std::string& data) {
+    if(m_closed) {
+        return false;
+    }
+    size_t sent = 0;
+    if(m_outbound.empty()) {
+        //nothing queued ahead of it, so send straight from data and only copy the remainder
+        while(sent < data.length()) {
+            ssize_t sendReturn = m_pTransport->sendTo(m_descriptor, data.data() + sent, data.length() - sent);
+            if(sendReturn < 0) {
+                if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    m_closed = true;
+                }
+                break;
+            }
+            sent += sendReturn;
+        }
+        if(sent == data.length()) {
+            return true;
+        }
+        if(m_closed) {
+            return false;
+        }
+    }
+    queueUnsent(data, sent);
+    return false;
+}
+
+/**
+ * Queues what is left of data after its first 'sent' bytes went straight to 
+ * the transport, e.g. from a broadcast that bypassed the socket. Only valid 
+ * while nothing else is queued, or the output would be reordered.
+ */
+void AsyncSocket::queueUnsent(const std::string& data, size_t sent) {
+    m_outbound.append(data, sent, std::string::npos);
+    flush();
+    if(m_outbound.size() - m_outboundSent > kMaxPendingOutput) {
+        m_closed = true;
+    }
+}
+
+/**
+ * Sends as much queued output as the transport accepts without blocking.
+ * 
+ * @return bool true once nothing is left queued, false otherwise (errno is left set on failure).
+ */
+bool AsyncSocket::flush() {
+    while(!m_closed && m_outboundSent < m_outbound.size()) {
+        ssize_t sendReturn = m_pTransport->sendTo(m_descriptor, m_outbound.data() + m_outboundSent, 
+            m_outbound.size() - m_outboundSent);
+        if(sendReturn < 0) {
+            if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                m_closed = true;
+            }
+            break;
+        }
+        m_outboundSent += sendReturn;
+    }
+    if(m_outboundSent == m_outbound.size()) {
+        m_outbound.clear(); //keeps its capacity, so steady-state sends do not reallocate
+        m_outboundSent = 0;
+        return true;
+    }
+    if(m_outboundSent >= kCompactAfter && m_outboundSent >= m_outbound.size() / 2) {
+        //a backlog that never fully drains would otherwise keep growing by its sent prefix
+        m_outbound.erase(0, m_outboundSent);
+        m_outboundSent = 0;
+    }
+    return false;
+}
+
+/**
+ * Flushes queued output and resumes the handler if what it is awaiting is now ready.
+ */
+void AsyncSocket::resumeIfReady() {
+    bool drained = flush();
+    if(!m_waiting) {
+        return;
+    }
+    bool ready = m_closed || (m_waitingForRead ? m_inbound.find('\n') != std::string::npos 
+        || m_inbound.size() >= kMaxLineLength : drained);
+    if(ready) {
+        std::coroutine_handle<> waiting = m_waiting;
+        m_waiting = nullptr;
+        waiting.resume();
+    }
+}
+
+/**
+ * @return bool true if resumeIfReady() has work to do without any new input: 
+ * output is still queued, a write is being awaited, or the client has gone.
+ */
+bool AsyncSocket::needsResumeOrFlush() {
+    if(m_closed) {
+        return (bool)m_waiting;
+    }
+    return !m_outbound.empty() || isWaitingForWrite();
+}
+
+/**
+ * @return bool true while queued output is waiting for the client to accept it.
+ */
+bool AsyncSocket::hasPendingOutput() {
+    return !m_closed && !m_outbound.empty();
+}
+
+/**
+ * @return size_t bytes held for output, including a sent prefix not yet compacted away.
+ */
+size_t AsyncSocket::getOutboundBufferSize() {
+    return m_outbound.size();
+}
+
+/**
+ * Moves the next complete line out of the inbound buffer. A line longer than 
+ * kMaxLineLength is rejected: it is handed over as an empty line, and the 
+ * rest of it is discarded up to its "\n" as it arrives.
+ * 
+ * @return bool true if a line was taken.
+ */
+bool AsyncSocket::takeLine(std::string& line) {
+    size_t end = m_inbound.find('\n');
+    if(end == std::string::npos) {
+        if(m_inbound.size() < kMaxLineLength) {
+            return false;
+        }
+        m_inbound.clear();
+        m_discardingLine = true;
+        line.clear();
+        return true;
+    }
+    if(end >= kMaxLineLength) {
+        m_inbound.erase(0, end + 1);
+        line.clear();
+        return true;
+    }
+    line.assign(m_inbound, 0, end + 1);
+    m_inbound.erase(0, end + 1);
+    return true;
+}
+
+AsyncSocket::ReadLineAwaiter::ReadLineAwaiter(AsyncSocket& socket, std::string& line) 
+    : m_socket(socket), m_line(line), m_gotLine(false) {
+}
+
+bool AsyncSocket::ReadLineAwaiter::await_ready() {
+    m_gotLine = m_socket.takeLine(m_line);
+    return m_gotLine || m_socket.m_closed;
+}
+
+void AsyncSocket::ReadLineAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    m_socket.m_waiting = handle;
+    m_socket.m_waitingForRead = true;
+}
+
+bool AsyncSocket::ReadLineAwaiter::await_resume() {
+    if(!m_gotLine) {
+        m_gotLine = m_socket.takeLine(m_line);
+    }
+    return m_gotLine;
+}
+
+AsyncSocket::WriteAwaiter::WriteAwaiter(AsyncSocket& socket, const std::string& data) 
+    : m_socket(socket) {
+    m_socket.queue(data);
+}
+
+bool AsyncSocket::WriteAwaiter::await_ready() {
+    return m_socket.m_closed || m_socket.m_outbound.empty();
+}
+
+void AsyncSocket::WriteAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    m_socket.m_waiting = handle;
+    m_socket.m_waitingForRead = false;
+}
+
+bool AsyncSocket::WriteAwaiter::await_resume() {
+    return !m_socket.m_closed;
+}
+
+}
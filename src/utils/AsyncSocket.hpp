@@ -0,0 +1,87 @@
+#ifndef ASYNCSOCKET_HPP_
+#define ASYNCSOCKET_HPP_
+
+#include "Transport.hpp"
+#include <coroutine>
+#include <string>
+
+namespace linuxservice {
+
+/**
+ * One client connection as seen by its coroutine handler. The handler awaits 
+ * whole lines and completed writes; ConnectionManager (the reactor) feeds in 
+ * bytes as they are read, flushes queued output as the client accepts it, and 
+ * resumes the handler once what it awaits is ready.
+ */
+class AsyncSocket {
+public:
+	AsyncSocket() = delete;
+	~AsyncSocket() = default;
+	AsyncSocket(const AsyncSocket&) = delete;
+	AsyncSocket& operator=(const AsyncSocket&) = delete;
+
+    AsyncSocket(Transport* pTransport, int descriptor);
+
+    class ReadLineAwaiter {
+    public:
+        ReadLineAwaiter(AsyncSocket& socket, std::string& line);
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        bool await_resume();
+    private:
+        AsyncSocket& m_socket;
+        std::string& m_line;
+        bool m_gotLine;
+    };
+
+    class WriteAwaiter {
+    public:
+        WriteAwaiter(AsyncSocket& socket, const std::string& data);
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        bool await_resume();
+    private:
+        AsyncSocket& m_socket;
+    };
+
+    //Handler side:
+    ReadLineAwaiter read_line(std::string& line);
+    WriteAwaiter write(const std::string& data);
+
+    //Reactor side:
+    int getDescriptor();
+    bool isWaitingForRead();
+    bool isWaitingForWrite();
+    void receive(const char* data, size_t length);
+    void markClosed();
+    bool isClosed();
+    bool queue(const std::string& data);
+    void queueUnsent(const std::string& data, size_t sent);
+    bool flush();
+    void resumeIfReady();
+    bool needsResumeOrFlush();
+    bool hasPendingOutput();
+    size_t getOutboundBufferSize();
+
+private:
+    static const size_t kMaxLineLength = 1024; //longer lines are rejected as empty
+    static const size_t kMaxPendingOutput = 1024 * 1024; //a consumer further behind than this is dropped
+    static const size_t kCompactAfter = 4096; //sent prefix size at which a partly drained m_outbound is compacted
+
+    //Ordered so everything queue() touches shares one cache line:
+    Transport* m_pTransport;
+    int m_descriptor;
+    bool m_closed;
+    bool m_waitingForRead;
+    bool m_discardingLine; //dropping input until the "\n" ending a rejected line
+    std::coroutine_handle<> m_waiting;
+    size_t m_outboundSent; //bytes at the front of m_outbound already sent
+    std::string m_outbound; //queued but not yet accepted by the transport
+    std::string m_inbound; //read but not yet handed to the handler
+
+    bool takeLine(std::string& line);
+};
+
+}
+
+#endif /* ASYNCSOCKET_HPP_ */
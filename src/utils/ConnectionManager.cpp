@@ -1,13 +1,13 @@
 #include "ConnectionManager.hpp"
 #include "CountAPI.hpp"
-
-#include <sys/time.h>
-#include <sys/types.h>
+#include "SocketTransport.hpp"
+#include "Tracepoints.hpp"
+#include <algorithm>
 
 namespace linuxservice {
 
 /**
- * Only constructor for ConnectionManager.
+ * Constructor for ConnectionManager over a real TCPServer.
  * ConnectionManager adds connection control between the passed TCPServer 
  * and the TCPServer's ultimate clients. ConnectionManager also ensures the
  * clients adhere to the InputCommands and OutputCommands defined by
@@ -19,69 +19,153 @@ namespace linuxservice {
  * @param serverSocket shared ptr to a TCPServer instance
  * @param api shared ptr to an API instance
  */
-ConnectionManager::ConnectionManager(std::shared_ptr<TCPServer> serverSocket, std::shared_ptr<API> api) {
-    m_pServerSocket = serverSocket;
+ConnectionManager::ConnectionManager(std::shared_ptr<TCPServer> serverSocket, std::shared_ptr<API> api) 
+    : ConnectionManager(std::shared_ptr<Transport>(new SocketTransport(serverSocket)), api) {
+}
+
+/**
+ * Constructor for ConnectionManager over any Transport, e.g. a LoopbackTransport 
+ * in tests and benchmarks.
+ * 
+ * @param transport shared ptr to a Transport instance
+ * @param api shared ptr to an API instance
+ */
+ConnectionManager::ConnectionManager(std::shared_ptr<Transport> transport, std::shared_ptr<API> api) {
+    m_pTransport = transport;
     m_pApi = api;
     m_maxConnections = 1024; //defined by spec
-    std::vector<int> m_connections;
+    m_nextConnectionId = 0;
+    m_handlerFinished = false;
 }
 
 /**
- * Adds any waiting clients to list of connections; checks all connections for data 
- * to read and performs API functionality.
+ * Adds any waiting clients to list of connections; reads from every connection 
+ * with data waiting, and resumes each connection's handler once the line or 
+ * write it is awaiting is ready. Connections whose handler has finished are 
+ * then closed.
+ * 
+ * Note: An idle connection (handler waiting for input, nothing left to send) 
+ * costs one entry in the pass's single poll of all clients and nothing else; 
+ * connections with queued output or an awaited write are tracked in 
+ * m_attentionList instead of being rescanned.
  * 
  * This function is intended to be placed in a server loop.
+ * 
+ * @return bool true if the pass accepted, read or resumed anything; false for an idle pass.
  */
-void ConnectionManager::handleConnections() {
+bool ConnectionManager::handleConnections() {
+    bool didWork = false;
+
     //Part 1: Polls server to accept new connections
     if(m_connections.size() < m_maxConnections) {
         int possibleNewSocketClient = pollServerForRead();
         if(possibleNewSocketClient > -1) {
-            m_connections.push_back(possibleNewSocketClient);
+            m_connections.push_back(std::unique_ptr<Connection>(new Connection(m_pTransport.get(), 
+                possibleNewSocketClient, m_nextConnectionId++, m_connections.size())));
+            m_descriptors.push_back(possibleNewSocketClient);
+            m_backlogged.push_back(false);
+            SCC_TRACE1(accept, possibleNewSocketClient);
+            if(m_pCapture) {
+                m_pCapture->recordEvent(m_connections.back()->connectionId, TrafficCapture::ACCEPT);
+            }
             std::cout << "New Connection added. Connections: " << m_connections.size() << std::endl;
+            Connection& connection = *m_connections.back();
+            connection.handler = startConnectionHandler(connection.socket);
+            afterHandlerRan(connection);
+            didWork = true;
         }
     } else {
         std::cout << "Max Connection Capacity: Server skipped polling for new connections." << std::endl;
     }
 
-    //Part 2: Polls clients for commands to read and handle
-    std::vector<int> stillActiveConnections;
-    for(int i = 0; i < m_connections.size(); i++){
-        int currentClientSocketDescriptor = m_connections.at(i);
-        //only polled sockets with successful reads/writes stay in active connections:
-        if(pollClientForRead(currentClientSocketDescriptor)){
-            stillActiveConnections.push_back(currentClientSocketDescriptor);
-        } else {
-            std::cout << "Connection removed." << std::endl;
+    //Part 2: Polls clients for input and resumes handlers waiting on it
+    pollClientsForRead();
+    for(size_t i = 0; i < m_readyIndexes.size(); i++){
+        Connection& connection = *m_connections[m_readyIndexes[i]];
+        //input for a handler blocked on a write stays unread, so it is not progress
+        if(connection.socket.isWaitingForRead() && !connection.socket.isClosed()){
+            readClientInput(connection);
+            connection.socket.resumeIfReady();
+            afterHandlerRan(connection);
+            didWork = true;
+        }
+    }
+
+    //Part 3: Flushes queued output and resumes handlers waiting on writes or closes
+    m_attentionScratch.swap(m_attentionList);
+    for(size_t i = 0; i < m_attentionScratch.size(); i++){
+        Connection& connection = *m_attentionScratch[i];
+        connection.inAttentionList = false;
+        if(!connection.handler.isDone()){
+            connection.socket.resumeIfReady();
+            afterHandlerRan(connection);
+        }
+        //a consumer still too slow to take its output is not progress, so the loop may sleep on it
+        didWork = didWork || !connection.inAttentionList;
+    }
+    m_attentionScratch.clear();
+
+    //Part 4: ensures only active connections remain in the 'connections' list
+    if(m_handlerFinished){
+        removeFinishedConnections();
+    }
+    return didWork;
+}
+
+/**
+ * Sleeps until a client is waiting to connect, a connection has input, a 
+ * connection with queued output can take more, or the timeout passes. Returns 
+ * at once if a connection's handler is due to be resumed. Input is not waited 
+ * for on a connection whose handler is blocked on a write, as it is not read 
+ * until the write completes.
+ * 
+ * This function is intended to be called between idle 'handleConnections' passes.
+ * 
+ * @param timeoutMs int longest sleep in milliseconds.
+ */
+void ConnectionManager::waitForActivity(int timeoutMs) {
+    m_writeWaitDescriptors.clear();
+    m_writeBlockedDescriptors.clear();
+    for(size_t i = 0; i < m_attentionList.size(); i++){
+        AsyncSocket& socket = m_attentionList[i]->socket;
+        if(!socket.hasPendingOutput()){
+            return;
+        }
+        m_writeWaitDescriptors.push_back(socket.getDescriptor());
+        if(socket.isWaitingForWrite()){
+            m_writeBlockedDescriptors.push_back(socket.getDescriptor());
+        }
+    }
+    const std::vector<int>* pReadWaitDescriptors = &m_descriptors;
+    if(!m_writeBlockedDescriptors.empty()){
+        std::sort(m_writeBlockedDescriptors.begin(), m_writeBlockedDescriptors.end());
+        m_readWaitDescriptors.clear();
+        for(size_t i = 0; i < m_descriptors.size(); i++){
+            if(!std::binary_search(m_writeBlockedDescriptors.begin(), m_writeBlockedDescriptors.end(), m_descriptors[i])){
+                m_readWaitDescriptors.push_back(m_descriptors[i]);
+            }
         }
+        pReadWaitDescriptors = &m_readWaitDescriptors;
+    }
+    bool includeListener = m_connections.size() < static_cast<size_t>(m_maxConnections);
+    if(m_pTransport->waitForEvents(includeListener, *pReadWaitDescriptors, m_writeWaitDescriptors, timeoutMs) < 0 
+        && errno != EINTR){
+        std::cerr << "Error waiting for activity: " << strerror(errno) << std::endl;
     }
-    m_connections = stillActiveConnections; //ensures only active connections remain in the 'connections' list 
 }
 
 /**
  * Helper for 'handleConnections'.
- * Uses select() to poll the fd_set of server socket descriptor for waiting 
- * clients then attempts to connect them.
+ * Polls the server's listening descriptor for waiting clients then attempts 
+ * to connect them.
  * 
  * @return int representing new client for successful accpetance, -1 for unsuccessful.
  */
 int ConnectionManager::pollServerForRead(){
-    struct timeval timer; 
-    fd_set readEvents;
-    int selectReturn;
-
-    int serverDescriptor = m_pServerSocket->getServerSocketDescriptor();
-    timer.tv_sec = 0;
-    timer.tv_usec = 0;
-
-    FD_ZERO(&readEvents);
-    FD_SET(serverDescriptor, &readEvents);
-
-    // don't care about writefds and exceptfds for this instance:
-    selectReturn = select((serverDescriptor+1), &readEvents, NULL, NULL, &timer);
+    int selectReturn = m_pTransport->pollForRead(m_pTransport->getListenerDescriptor());
 
     if (selectReturn == -1) {
-        std::cerr << "Error in server select(): " << strerror(errno) << std::endl;
+        std::cerr << "Error in server poll(): " << strerror(errno) << std::endl;
         return selectReturn;
     } else if (selectReturn > 0) {
         return(acceptConnections());
@@ -101,114 +185,190 @@ int ConnectionManager::pollServerForRead(){
  * @return int representing descriptor of now accepted client socket or -1 for failure.
  */
 int ConnectionManager::acceptConnections(){
-    struct sockaddr_in address(m_pServerSocket->getServerAddress());
-    int addrlen = sizeof(address);
     int socketDescriptor;
 
-    if ((socketDescriptor = accept(m_pServerSocket->getServerSocketDescriptor(), 
-        (struct sockaddr *)&address, (socklen_t*)&addrlen)) < 0) { 
+    if ((socketDescriptor = m_pTransport->acceptClient()) < 0) { 
         std::cerr << "New Client Acceptance Failed: " << strerror(errno) << std::endl;
-    } else {
-        //notifies client socket of server acceptance
-        const char* toSend = "---Connection Accepted---\r\n";
-		if(send(socketDescriptor , toSend , strlen(toSend) , 0 ) < 0){
-            std::cerr << "New Client Send Failed: " << strerror(errno) << std::endl;
-            socketDescriptor = -1;
-        }
     }
     return socketDescriptor;
 }
 
 /**
  * Helper for 'handleConnections'.
- * Uses select() to poll the fd_set of passed socket descriptor for data then attempts read.
+ * Polls every client socket for data in one call, leaving the position in 
+ * m_descriptors of each one with data (or a close or error) to read in m_readyIndexes.
  * 
- * @param clientSocketDescriptor int that identifies a specific accepted client socket.
- * @return bool representing true for successful read, false for unsuccessful.
+ * @return int -1 for a failed poll, otherwise the number of clients ready.
  */
-bool ConnectionManager::pollClientForRead(int clientSocketDescriptor) {
-    struct timeval timer; 
-    fd_set readEvents; //could add writeEvents & exceptionEvents handling in future versions
-    int selectReturn;
-
-    timer.tv_sec = 0;
-    timer.tv_usec = 0;
-
-    FD_ZERO(&readEvents);
-    FD_SET(clientSocketDescriptor, &readEvents);
-
-    //writeEvents and exceptionEvents would replace the NULLS accordingly
-    selectReturn = select((clientSocketDescriptor+1), &readEvents, NULL, NULL, &timer);
+int ConnectionManager::pollClientsForRead() {
+    int pollReturn = m_pTransport->pollManyForRead(m_descriptors, m_readyIndexes);
 
-    if (selectReturn == -1) {
-        std::cerr << "Error in client select(): " << strerror(errno) << std::endl;
-        return false;
-    } else if (selectReturn > 0) {
-        return(readClientInput(clientSocketDescriptor));
-    } else {
-        //Timeout
+    if (pollReturn == -1) {
+        std::cerr << "Error in client poll(): " << strerror(errno) << std::endl;
     }
-
-    return true;
+    return pollReturn;
 }
 
 /**
- * Helper for 'pollClientForRead'.
- * Attempts to read input from a client which was identified in select() call.
+ * Helper for 'handleConnections'.
+ * Reads whatever the client has sent into its AsyncSocket, where the 
+ * connection's handler picks it up line by line.
  * 
  * Note: Though there is confirmation that data is in fact available, 
  * the client could drop off at any time.
  * 
- * @param socketDescriptor int that identifies a specific accepted client socket.
- * @return bool representing true for successful I/O handling, false for unsuccessful.
+ * @param connection the connection identified in the poll.
  */
-bool ConnectionManager::readClientInput(int socketDescriptor){
-    int readReturn;
+void ConnectionManager::readClientInput(Connection& connection){
+    int socketDescriptor = connection.socket.getDescriptor();
+    ssize_t readReturn;
     const int bufferSize = 1024;
-    char readBuffer[bufferSize] = {0};
-    if((readReturn = read(socketDescriptor , readBuffer, bufferSize)) < 0){
+    char readBuffer[bufferSize];
+    if((readReturn = m_pTransport->readFrom(socketDescriptor , readBuffer, bufferSize)) < 0){
+        if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return;
+        }
         std::cerr << "Socket Read Failed: " << strerror(errno) << std::endl;
-        return false;
+        connection.socket.markClosed();
+        m_backlogged[connection.index] = true; //so broadcasts see it has gone
+        return;
+    } else if(readReturn == 0) {
+        //client closed its end of the connection
+        connection.socket.markClosed();
+        m_backlogged[connection.index] = true; //so broadcasts see it has gone
+        return;
+    }
+    SCC_TRACE2(read, socketDescriptor, readReturn);
+    if(m_pCapture) {
+        m_pCapture->record(connection.connectionId, readBuffer, readReturn);
+    }
+    connection.socket.receive(readBuffer, readReturn);
+}
+
+/**
+ * Helper for 'handleConnections'.
+ * Records what a connection's handler left behind after it ran: a finished 
+ * handler for removal, queued output or an awaited write for the attention list, 
+ * and whether broadcasts must go through its AsyncSocket.
+ */
+void ConnectionManager::afterHandlerRan(Connection& connection) {
+    m_backlogged[connection.index] = connection.socket.isClosed() || connection.socket.hasPendingOutput();
+    if(connection.handler.isDone()){
+        m_handlerFinished = true;
+    } else if(connection.socket.needsResumeOrFlush()){
+        flagForAttention(connection);
+    }
+}
+
+/**
+ * Adds a connection to the attention list once.
+ */
+void ConnectionManager::flagForAttention(Connection& connection) {
+    if(!connection.inAttentionList){
+        connection.inAttentionList = true;
+        m_attentionList.push_back(&connection);
     }
-    //Passes the read contents from the client to the APIs supported by ConnectionManager:
+}
+
+/**
+ * Helper for 'handleConnections'.
+ * Closes and drops every connection whose handler has returned.
+ */
+void ConnectionManager::removeFinishedConnections() {
+    size_t kept = 0;
+    for(size_t i = 0; i < m_attentionList.size(); i++){
+        if(!m_attentionList[i]->handler.isDone()){
+            m_attentionList[kept++] = m_attentionList[i];
+        }
+    }
+    m_attentionList.resize(kept);
+
+    kept = 0;
+    for(size_t i = 0; i < m_connections.size(); i++){
+        if(m_connections[i]->handler.isDone()){
+            int socketDescriptor = m_descriptors[i];
+            SCC_TRACE1(connection_close, socketDescriptor);
+            if(m_pCapture) {
+                m_pCapture->recordEvent(m_connections[i]->connectionId, TrafficCapture::CLOSE);
+            }
+            m_connections[i].reset(); //destroys the handler's frame before the descriptor can be reused
+            m_pTransport->closeConnection(socketDescriptor);
+            std::cout << "Connection removed." << std::endl;
+        } else {
+            m_descriptors[kept] = m_descriptors[i];
+            m_backlogged[kept] = m_backlogged[i];
+            m_connections[i]->index = kept;
+            m_connections[kept++].swap(m_connections[i]);
+        }
+    }
+    m_connections.resize(kept);
+    m_descriptors.resize(kept);
+    m_backlogged.resize(kept);
+    m_handlerFinished = false;
+}
+
+/**
+ * Helper for 'handleConnections'.
+ * Starts the protocol handler for a newly accepted connection of the API 
+ * supported by ConnectionManager.
+ * 
+ * @param socket the new connection's AsyncSocket; outlives the returned task.
+ * @return ConnectionTask running the handler (finished at once if the API is unsupported).
+ */
+ConnectionTask ConnectionManager::startConnectionHandler(AsyncSocket& socket) {
     std::string apiType = m_pApi->getApiType();
     if(apiType == "CountAPI") {
-        return handleInputForCountApi(socketDescriptor, readBuffer);
+        return handleCountApiConnection(socket);
     } else if(apiType == "newAPI") {
-        //Add new API command handling here e.g. handleInputForNewApi(socketDescriptor, readBuffer);
+        //Add new API connection handling here e.g. return handleNewApiConnection(socket);
     } else {
         std::cerr << "The passed API is not supported by ConnectionManager." << std::endl;
     }
-    return true;
+    return ConnectionTask();
 }
 
 /**
- * Helper for 'readClientInput'.
- * Passes the successfully read input into the correct API for handling.
+ * Protocol handler for one CountAPI connection, run as a coroutine. Greets the 
+ * client, then passes each line it sends to the CountAPI: INCR, DECR and BATCH 
+ * results go to every connection, anything else only back to the sender.
  * 
- * Note: Though there is confirmation that read() was successful, 
- * the client could drop off at any time and fail the send().
+ * Note: Returning ends the connection; this happens once the client drops 
+ * off or a send to it fails.
  * 
- * @param socketDescriptor address for the socket descriptor.
- * @param readBuffer string passed from a successful read() associated with socketDescriptor.
- * @return bool representing true for successful I/O handling, false for unsuccessful.
+ * @param socket the connection's AsyncSocket.
+ * @return ConnectionTask owning the coroutine.
  */
-bool ConnectionManager::handleInputForCountApi(int& socketDescriptor, std::string readBuffer){
-    std::string handledToSend = "Not a command handled by the server.\r\n";
+ConnectionTask ConnectionManager::handleCountApiConnection(AsyncSocket& socket) {
+    //notifies client socket of server acceptance
+    if(!co_await socket.write("---Connection Accepted---\r\n")){
+        std::cerr << "New Client Send Failed." << std::endl;
+        co_return;
+    }
+
     //can confidently cast here bc of the API type string check:
-    CountAPI::InputCommand command = static_cast<CountAPI&>(*m_pApi).handleInCommand(readBuffer, handledToSend);
-    if(command == CountAPI::INCR || command == CountAPI::DECR){
-        sendToAllConnections(handledToSend);
-    } else {
-        const char* toSend = handledToSend.c_str();
-        if((send(socketDescriptor , toSend , strlen(toSend) , 0 )) < 0){
-            std::cerr << "Socket Send Failed: " << strerror(errno) << std::endl;
-            return false;
+    CountAPI& countApi = static_cast<CountAPI&>(*m_pApi);
+    std::string line;
+    std::string handledToSend;
+    while(co_await socket.read_line(line)){
+        int socketDescriptor = socket.getDescriptor();
+        int countBefore = countApi.getCount();
+        handledToSend = "Not a command handled by the server.\r\n";
+        CountAPI::InputCommand command = countApi.handleInCommand(line, handledToSend);
+        SCC_TRACE2(command_parsed, socketDescriptor, static_cast<int>(command));
+        if(command == CountAPI::INCR || command == CountAPI::DECR || command == CountAPI::BATCH){
+            SCC_TRACE3(count_applied, socketDescriptor, countApi.getCount() - countBefore, countApi.getCount());
+            sendToAllConnections(handledToSend);
+            SCC_TRACE2(command_done, socketDescriptor, static_cast<int>(command));
         } else {
+            SCC_TRACE2(reply_queued, socketDescriptor, handledToSend.length());
+            if(!co_await socket.write(handledToSend)){
+                std::cerr << "Socket Send Failed." << std::endl;
+                co_return;
+            }
+            SCC_TRACE2(command_done, socketDescriptor, static_cast<int>(command));
             std::cout << "Server sent message '" << handledToSend << "' ."<< std::endl;
         }
     }
-    return true;
 }
 
 /**
@@ -220,28 +380,95 @@ bool ConnectionManager::handleInputForCountApi(int& socketDescriptor, std::strin
 void ConnectionManager::shutdownAllConnections() {
     for(int i = 0; i < m_connections.size(); i++){
          //file descriptor at i no longer read/writable but still open
-        if((shutdown(m_connections.at(i), SHUT_RDWR)) < 0){
+        if((m_pTransport->shutdownConnection(m_descriptors.at(i))) < 0){
             std::cerr << "Failure shutting down a connection.: " << strerror(errno) << std::endl;
         }
     }
 }
 
 /**
- * Sends passed string to all active connections.
+ * Turns on capture mode: every accept, close and command read from a client 
+ * is handed to the passed TrafficCapture along with an id unique to that 
+ * client's connection.
  * 
- * Note: Though m_connections is constantly being polled/evaluated for 
- * dropped connections, it is possible a connection could drop at any time.
+ * @param capture shared ptr to an open TrafficCapture, or null to stop capturing.
+ */
+void ConnectionManager::setTrafficCapture(std::shared_ptr<TrafficCapture> capture) {
+    m_pCapture = capture;
+}
+
+/**
+ * Setter for the number of connections accepted before new clients are left waiting.
+ * 
+ * @param maxConnections int upper bound on active connections.
+ */
+void ConnectionManager::setMaxConnections(int maxConnections) {
+    m_maxConnections = maxConnections;
+    //sized up front so accepting up to the limit never reallocates mid-loop
+    m_connections.reserve(maxConnections);
+    m_descriptors.reserve(maxConnections);
+    m_backlogged.reserve(maxConnections);
+    m_readyIndexes.reserve(maxConnections);
+    m_attentionList.reserve(maxConnections);
+    m_attentionScratch.reserve(maxConnections);
+    m_writeWaitDescriptors.reserve(maxConnections);
+    m_writeBlockedDescriptors.reserve(maxConnections);
+    m_readWaitDescriptors.reserve(maxConnections);
+}
+
+/**
+ * Getter for the number of active connections.
+ * 
+ * @return size_t size of m_connections.
+ */
+size_t ConnectionManager::getConnectionCount() {
+    return m_connections.size();
+}
+
+/**
+ * Queues passed string to all active connections. Each connection sends what 
+ * it can straight away; the rest goes out on later server loop passes, so a 
+ * slow consumer does not hold up the others.
+ * 
+ * Note: A connection without a backlog is sent to straight from m_descriptors, 
+ * and its Connection is only touched if the send falls short. Though 
+ * m_connections is constantly being polled/evaluated for dropped connections, 
+ * it is possible a connection could drop at any time.
  * 
  * @param sendToAll string intended to send to all connections.
  */
-void ConnectionManager::sendToAllConnections(std::string sendToAll) {
-    for(int i = 0; i < m_connections.size(); i++){
-        if(send(m_connections.at(i) , sendToAll.c_str() , sendToAll.length() , 0 ) < 0){
-            std::cerr << "Failure sending message to a socket descriptor: " << strerror(errno) << std::endl;
+void ConnectionManager::sendToAllConnections(const std::string& sendToAll) {
+    int failedSends = 0;
+    SCC_TRACE2(broadcast_start, m_connections.size(), sendToAll.length());
+    const char* data = sendToAll.data();
+    ssize_t length = sendToAll.length();
+    for(size_t i = 0; i < m_descriptors.size(); i++){
+        if(!m_backlogged[i]){
+            ssize_t sendReturn = m_pTransport->sendTo(m_descriptors[i], data, length);
+            if(sendReturn == length){
+                continue; //sent in full, so there is nothing new to track
+            }
+            if(sendReturn < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR){
+                m_connections[i]->socket.markClosed();
+            } else {
+                m_connections[i]->socket.queueUnsent(sendToAll, sendReturn < 0 ? 0 : sendReturn);
+            }
+        } else {
+            //queued output must go out first, so this joins the queue
+            m_connections[i]->socket.queue(sendToAll);
+        }
+        Connection& connection = *m_connections[i];
+        m_backlogged[i] = connection.socket.isClosed() || connection.socket.hasPendingOutput();
+        if(connection.socket.isClosed()){
+            failedSends++;
+        }
+        if(connection.socket.needsResumeOrFlush()){
+            flagForAttention(connection);
         }
     }
+    SCC_TRACE2(broadcast_end, m_connections.size(), failedSends);
     std::cout << "Server sent message '" << sendToAll << "' to all active connections."<< std::endl;
         
 }
 
-}
\ No newline at end of file
+}
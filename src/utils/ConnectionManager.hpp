@@ -2,13 +2,19 @@
 #define CONNECTIONMANAGER_HPP_
 
 #include "API.hpp"
+#include "AsyncSocket.hpp"
+#include "ConnectionTask.hpp"
 #include "TCPServer.hpp"
+#include "Transport.hpp"
+#include "TrafficCapture.hpp"
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <unistd.h> 
 #include <stdio.h> 
 #include <sys/socket.h> 
 #include <stdlib.h> 
+#include <string.h>
 #include <netinet/in.h>
 
 namespace linuxservice {
@@ -21,22 +27,52 @@ public:
 	ConnectionManager& operator=(const ConnectionManager&) = delete;
 
     ConnectionManager(std::shared_ptr<TCPServer> serverSocket, std::shared_ptr<API> api);
+    ConnectionManager(std::shared_ptr<Transport> transport, std::shared_ptr<API> api);
 
-    void handleConnections();
+    bool handleConnections();
+    void waitForActivity(int timeoutMs);
     void shutdownAllConnections();
+    void setTrafficCapture(std::shared_ptr<TrafficCapture> capture);
+    void setMaxConnections(int maxConnections);
+    size_t getConnectionCount();
 
 private:
-    std::shared_ptr<TCPServer> m_pServerSocket;
+    std::shared_ptr<Transport> m_pTransport;
     std::shared_ptr<API> m_pApi;
     int m_maxConnections;
-    std::vector<int> m_connections;
+    std::shared_ptr<TrafficCapture> m_pCapture; //null unless capture mode is on
+    uint32_t m_nextConnectionId;
+
+    struct Connection {
+        Connection(Transport* pTransport, int descriptor, uint32_t id, size_t position) 
+            : socket(pTransport, descriptor), connectionId(id), index(position), inAttentionList(false) {}
+        AsyncSocket socket;
+        uint32_t connectionId; //unique for the server's lifetime, unlike descriptors
+        size_t index; //position in m_connections and its parallel vectors
+        bool inAttentionList;
+        ConnectionTask handler; //declared after socket so it is destroyed first
+    };
+    std::vector<std::unique_ptr<Connection>> m_connections;
+    std::vector<int> m_descriptors; //parallel to m_connections; idle connections are only polled through this
+    std::vector<char> m_backlogged; //parallel to m_connections; set while output is queued or the client has gone
+    std::vector<Connection*> m_attentionList; //connections needing a flush or resume next pass
+    std::vector<Connection*> m_attentionScratch; //reused so each pass does not reallocate
+    std::vector<size_t> m_readyIndexes; //positions in m_descriptors found readable this pass
+    std::vector<int> m_writeWaitDescriptors; //reused by waitForActivity()
+    std::vector<int> m_writeBlockedDescriptors; //reused by waitForActivity()
+    std::vector<int> m_readWaitDescriptors; //reused by waitForActivity()
+    bool m_handlerFinished;
 
     int pollServerForRead();
-    bool pollClientForRead(int clientSocketDescriptor);
-    bool readClientInput(int socketDescriptor);
+    int pollClientsForRead();
+    void readClientInput(Connection& connection);
     int acceptConnections();
-    void sendToAllConnections(std::string sendToAll);
-    bool handleInputForCountApi(int& socketDescriptor, std::string readBuffer);
+    void afterHandlerRan(Connection& connection);
+    void flagForAttention(Connection& connection);
+    void removeFinishedConnections();
+    void sendToAllConnections(const std::string& sendToAll);
+    ConnectionTask startConnectionHandler(AsyncSocket& socket);
+    ConnectionTask handleCountApiConnection(AsyncSocket& socket);
 };
 
 }
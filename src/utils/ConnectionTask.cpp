@@ -0,0 +1,108 @@
+#include "ConnectionTask.hpp"
+#include <exception>
+#include <iostream>
+#include <new>
+
+namespace linuxservice {
+
+FramePool::FreeBlock* FramePool::s_freeLists[FramePool::kSizeClasses] = {NULL};
+size_t FramePool::s_blocksAllocated = 0;
+
+/**
+ * Hands out a frame of at least 'size' bytes, reusing a released one of the 
+ * same size class when available.
+ * 
+ * @param size bytes requested by the compiler for a coroutine frame.
+ * @return void* start of the frame.
+ */
+void* FramePool::allocate(size_t size) {
+    size_t sizeClass = (size + kGranularity - 1) / kGranularity;
+    if(sizeClass >= kSizeClasses) {
+        return ::operator new(size);
+    }
+    FreeBlock* pBlock = s_freeLists[sizeClass];
+    if(pBlock != NULL) {
+        s_freeLists[sizeClass] = pBlock->pNext;
+        return pBlock;
+    }
+    s_blocksAllocated++;
+    return ::operator new(sizeClass * kGranularity);
+}
+
+/**
+ * Returns a frame to its size class's free list.
+ * 
+ * @param pFrame frame previously returned by allocate().
+ * @param size the same size that was passed to allocate().
+ */
+void FramePool::release(void* pFrame, size_t size) {
+    size_t sizeClass = (size + kGranularity - 1) / kGranularity;
+    if(sizeClass >= kSizeClasses) {
+        ::operator delete(pFrame);
+        return;
+    }
+    FreeBlock* pBlock = static_cast<FreeBlock*>(pFrame);
+    pBlock->pNext = s_freeLists[sizeClass];
+    s_freeLists[sizeClass] = pBlock;
+}
+
+/**
+ * Getter for how many pooled blocks have ever been taken from the heap.
+ * 
+ * @return size_t count that stays flat once frames are being recycled.
+ */
+size_t FramePool::getBlocksAllocated() {
+    return s_blocksAllocated;
+}
+
+ConnectionTask ConnectionTask::promise_type::get_return_object() {
+    return ConnectionTask(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+/**
+ * A handler that throws ends its connection rather than the server.
+ */
+void ConnectionTask::promise_type::unhandled_exception() {
+    try { throw; }
+    catch (const std::exception& e) {
+        std::cerr << "Connection handler failed: " << e.what() << std::endl;
+    }
+    catch (...) {
+        std::cerr << "Connection handler failed." << std::endl;
+    }
+}
+
+ConnectionTask::ConnectionTask(std::coroutine_handle<promise_type> handle) 
+    : m_handle(handle) {
+}
+
+ConnectionTask::~ConnectionTask() {
+    if(m_handle) {
+        m_handle.destroy();
+    }
+}
+
+ConnectionTask::ConnectionTask(ConnectionTask&& other) noexcept 
+    : m_handle(other.m_handle) {
+    other.m_handle = nullptr;
+}
+
+ConnectionTask& ConnectionTask::operator=(ConnectionTask&& other) noexcept {
+    if(this != &other) {
+        if(m_handle) {
+            m_handle.destroy();
+        }
+        m_handle = other.m_handle;
+        other.m_handle = nullptr;
+    }
+    return *this;
+}
+
+/**
+ * @return bool true once the handler has returned (or there is no handler).
+ */
+bool ConnectionTask::isDone() {
+    return !m_handle || m_handle.done();
+}
+
+}
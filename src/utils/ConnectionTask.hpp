@@ -0,0 +1,72 @@
+#ifndef CONNECTIONTASK_HPP_
+#define CONNECTIONTASK_HPP_
+
+#include <coroutine>
+#include <stddef.h>
+
+namespace linuxservice {
+
+/**
+ * Free-list allocator for coroutine frames. Frames are rounded up to a size 
+ * class and recycled on release, so once the pool is warm, starting a 
+ * connection handler does not touch the heap.
+ * 
+ * Note: Not thread safe; frames are only created and destroyed on the server loop.
+ */
+class FramePool {
+public:
+	FramePool() = delete;
+
+    static void* allocate(size_t size);
+    static void release(void* pFrame, size_t size);
+    static size_t getBlocksAllocated();
+
+private:
+    struct FreeBlock {
+        FreeBlock* pNext;
+    };
+
+    static const size_t kGranularity = 64;
+    static const size_t kSizeClasses = 64; //pools frames up to 4 KB; larger ones use the heap directly
+
+    static FreeBlock* s_freeLists[kSizeClasses];
+    static size_t s_blocksAllocated;
+};
+
+/**
+ * Coroutine type for one connection's protocol handler. The handler starts 
+ * running as soon as it is called and runs until its first co_await; from 
+ * then on ConnectionManager resumes it when the awaited I/O is ready.
+ * ConnectionTask owns the coroutine frame and destroys it with the task.
+ */
+class ConnectionTask {
+public:
+    struct promise_type {
+        ConnectionTask get_return_object();
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; } //frame stays until the task is destroyed
+        void return_void() {}
+        void unhandled_exception();
+
+        static void* operator new(size_t size) { return FramePool::allocate(size); }
+        static void operator delete(void* pFrame, size_t size) { FramePool::release(pFrame, size); }
+    };
+
+	ConnectionTask() = default;
+	~ConnectionTask();
+	ConnectionTask(const ConnectionTask&) = delete;
+	ConnectionTask& operator=(const ConnectionTask&) = delete;
+    ConnectionTask(ConnectionTask&& other) noexcept;
+    ConnectionTask& operator=(ConnectionTask&& other) noexcept;
+
+    bool isDone();
+
+private:
+    explicit ConnectionTask(std::coroutine_handle<promise_type> handle);
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+}
+
+#endif /* CONNECTIONTASK_HPP_ */
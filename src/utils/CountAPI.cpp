@@ -1,5 +1,8 @@
 #include "CountAPI.hpp"
 #include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
 
 namespace linuxservice {
 
@@ -46,6 +49,11 @@ CountAPI::InputCommand CountAPI::handleInCommand(std::string& rawInput, std::str
         return CountAPI::InputCommand::OUTPUT;
     }
 
+    //a batch carries its own list of commands, so it is parsed separately
+    if(rawInput.compare(0, 6, "BATCH ") == 0){
+        return handleBatchCommand(rawInput, output);
+    }
+
     //now split at the space:
     std::string delimiter = " ";
     size_t pos = 0;
@@ -66,7 +74,8 @@ CountAPI::InputCommand CountAPI::handleInCommand(std::string& rawInput, std::str
 		}
         m_count+=val;
         std::string ctStr = std::to_string(m_count);
-        output = "Increased by " + rawInput + " (Current Count: " + ctStr + ")" + crlf;
+        //the parsed value, not rawInput, so the reply is one line without the input's "\r\n"
+        output = "Increased by " + std::to_string(val) + " (Current Count: " + ctStr + ")" + crlf;
         return CountAPI::InputCommand::INCR;
     } else if(command == "DECR"){
         int val = 0;
@@ -78,11 +87,72 @@ CountAPI::InputCommand CountAPI::handleInCommand(std::string& rawInput, std::str
 		}
         m_count-=val;
         std::string ctStr = std::to_string(m_count);
-        output = "Decreased by " + rawInput + " (Current Count: " + ctStr + ")" + crlf;
+        //the parsed value, not rawInput, so the reply is one line without the input's "\r\n"
+        output = "Decreased by " + std::to_string(val) + " (Current Count: " + ctStr + ")" + crlf;
         return CountAPI::InputCommand::DECR;
     } else {
         return CountAPI::InputCommand::INVALID;
     }
 }
 
-}
\ No newline at end of file
+/**
+ * Parses a 'BATCH' input of the form "BATCH INCR 5 DECR 2 INCR 7" and applies 
+ * every INCR/DECR in it as one net change to the count. 
+ * 
+ * Note: The whole batch is validated before the count is touched, so a batch 
+ * containing any bad command or value leaves the count unchanged.
+ * 
+ * @param[in] rawInput address for the string of raw input from the server.
+ * @param[out] output address for the string of output that may be used elsewhere.
+ * @return CountAPI::InputCommand BATCH for an applied batch, INVALID otherwise.
+ */
+CountAPI::InputCommand CountAPI::handleBatchCommand(std::string& rawInput, std::string& output){
+    std::string crlf = "\r\n";
+    std::istringstream tokens(rawInput);
+    std::string command;
+    std::string value;
+    long long netDelta = 0;
+    int commandCount = 0;
+
+    tokens >> command; //skips the leading 'BATCH'
+    while(tokens >> command){
+        if(command != "INCR" && command != "DECR"){
+            output = "BATCH only takes INCR and DECR commands. " + crlf;
+            std::cerr << "BATCH only takes INCR and DECR commands. Got: " << command << std::endl;
+            return CountAPI::InputCommand::INVALID;
+        }
+        int val = 0;
+        try {
+            if(!(tokens >> value)) { throw std::invalid_argument("missing value"); }
+            size_t parsed = 0;
+            val = stoi(value, &parsed);
+            if(parsed != value.length()) { throw std::invalid_argument(value); }
+        }
+        catch (const std::exception& e) {
+            output = "BATCH " + command + " command takes an integer. " + crlf;
+            std::cerr << "BATCH " << command << " command takes an integer. " << e.what() << std::endl;
+            return CountAPI::InputCommand::INVALID;
+        }
+        netDelta += (command == "INCR") ? val : -static_cast<long long>(val);
+        commandCount++;
+    }
+
+    if(commandCount == 0){
+        output = "BATCH command takes at least one INCR or DECR. " + crlf;
+        return CountAPI::InputCommand::INVALID;
+    }
+
+    long long newCount = m_count + netDelta;
+    if(newCount > std::numeric_limits<int>::max() || newCount < std::numeric_limits<int>::min()){
+        output = "BATCH would take the count out of range. " + crlf;
+        std::cerr << "BATCH would take the count out of range." << std::endl;
+        return CountAPI::InputCommand::INVALID;
+    }
+    m_count = static_cast<int>(newCount);
+    std::string ctStr = std::to_string(m_count);
+    output = "Batch of " + std::to_string(commandCount) + " changed count by " 
+        + std::to_string(netDelta) + " (Current Count: " + ctStr + ")" + crlf;
+    return CountAPI::InputCommand::BATCH;
+}
+
+}
@@ -16,6 +16,7 @@ public:
         INCR,
         DECR,
         OUTPUT,
+        BATCH,
         INVALID
     };
 
@@ -32,6 +33,8 @@ public:
 private:
     int m_count;
 
+    InputCommand handleBatchCommand(std::string& rawInput, std::string& output);
+
 };
 
 }
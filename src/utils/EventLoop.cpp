@@ -0,0 +1,44 @@
+#include "EventLoop.hpp"
+
+namespace linuxservice {
+
+/**
+ * Only constructor for EventLoop.
+ * EventLoop drives a ConnectionManager's passes and decides what the server 
+ * thread does when there is nothing to handle: sleep (BLOCKING), spin for a 
+ * while then sleep (ADAPTIVE), or keep spinning (BUSY_POLL).
+ * 
+ * @param connectionManager ConnectionManager to drive; must outlive the loop.
+ * @param waitStrategy ServerConfig::WaitStrategy for idle passes.
+ * @param spinPasses int idle passes ADAPTIVE spins through before sleeping.
+ */
+EventLoop::EventLoop(ConnectionManager& connectionManager, ServerConfig::WaitStrategy waitStrategy, int spinPasses) 
+    : m_connectionManager(connectionManager) {
+    m_waitStrategy = waitStrategy;
+    m_spinPasses = spinPasses;
+}
+
+/**
+ * Runs server passes until keepRunning is cleared (e.g. by a signal handler).
+ * 
+ * @param keepRunning flag checked between passes.
+ */
+void EventLoop::run(volatile sig_atomic_t& keepRunning) {
+    int idlePasses = 0;
+    while(keepRunning){
+        if(m_connectionManager.handleConnections()){
+            idlePasses = 0;
+            continue;
+        }
+        if(m_waitStrategy == ServerConfig::BUSY_POLL){
+            continue;
+        }
+        if(m_waitStrategy == ServerConfig::ADAPTIVE && ++idlePasses < m_spinPasses){
+            continue;
+        }
+        idlePasses = 0;
+        m_connectionManager.waitForActivity(kMaxWaitMs);
+    }
+}
+
+}
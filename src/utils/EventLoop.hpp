@@ -0,0 +1,31 @@
+#ifndef EVENTLOOP_HPP_
+#define EVENTLOOP_HPP_
+
+#include "ConnectionManager.hpp"
+#include "ServerConfig.hpp"
+#include <csignal>
+
+namespace linuxservice {
+
+class EventLoop {
+public:
+	EventLoop() = delete;
+	~EventLoop() = default;
+	EventLoop(const EventLoop&) = delete;
+	EventLoop& operator=(const EventLoop&) = delete;
+
+    EventLoop(ConnectionManager& connectionManager, ServerConfig::WaitStrategy waitStrategy, int spinPasses);
+
+    void run(volatile sig_atomic_t& keepRunning);
+
+private:
+    static const int kMaxWaitMs = 100; //bounds how long a blocked loop takes to notice keepRunning
+
+    ConnectionManager& m_connectionManager;
+    ServerConfig::WaitStrategy m_waitStrategy;
+    int m_spinPasses;
+};
+
+}
+
+#endif /* EVENTLOOP_HPP_ */
@@ -0,0 +1,277 @@
+#include "LoopbackTransport.hpp"
+
+#include <algorithm>
+#include <errno.h>
+#include <limits>
+#include <string.h>
+
+namespace linuxservice {
+
+static const int kListenerDescriptor = 3;
+static const int kFirstClientDescriptor = 4;
+
+/**
+ * Only constructor for LoopbackTransport.
+ * LoopbackTransport is an in-memory Transport for tests and benchmarks. It 
+ * plays both sides: ConnectionManager drives the server side through the 
+ * Transport calls, while the caller drives any number of simulated clients. 
+ * Partial reads, partial writes and slow consumers can be simulated with the 
+ * 'set' functions. No sockets or system calls are involved.
+ */
+LoopbackTransport::LoopbackTransport() {
+    m_maxReadChunk = std::numeric_limits<size_t>::max();
+    m_maxSendChunk = std::numeric_limits<size_t>::max();
+    m_discardOutput = false;
+    m_bytesSent = 0;
+}
+
+int LoopbackTransport::getListenerDescriptor() {
+    return kListenerDescriptor;
+}
+
+/**
+ * @param descriptor listener or client descriptor to poll.
+ * @return int -1 (EBADF) for unknown descriptors, 0 when nothing is waiting, 1 when readable.
+ */
+int LoopbackTransport::pollForRead(int descriptor) {
+    if(descriptor == kListenerDescriptor) {
+        return m_pendingAccepts.empty() ? 0 : 1;
+    }
+    Client* pClient = findClient(descriptor);
+    if(pClient == NULL || pClient->serverClosed) {
+        errno = EBADF;
+        return -1;
+    }
+    return (!pClient->inbound.empty() || pClient->clientClosed) ? 1 : 0;
+}
+
+/**
+ * Checks each passed descriptor as pollForRead() does.
+ * 
+ * @return int number of descriptors with input waiting, a closed client or an error.
+ */
+int LoopbackTransport::pollManyForRead(const std::vector<int>& descriptors, std::vector<size_t>& readyIndexes) {
+    readyIndexes.clear();
+    for(size_t i = 0; i < descriptors.size(); i++) {
+        if(pollForRead(descriptors[i]) != 0) {
+            readyIndexes.push_back(i);
+        }
+    }
+    return readyIndexes.size();
+}
+
+/**
+ * Reports whether anything is ready. There is no real time in the loopback, 
+ * so it never sleeps: the timeout is ignored.
+ * 
+ * @return int 1 if a listed descriptor is ready, 0 otherwise.
+ */
+int LoopbackTransport::waitForEvents(bool includeListener, const std::vector<int>& readDescriptors, 
+    const std::vector<int>& writeDescriptors, int timeoutMs) {
+    if(includeListener && !m_pendingAccepts.empty()) {
+        return 1;
+    }
+    for(size_t i = 0; i < readDescriptors.size(); i++) {
+        if(pollForRead(readDescriptors[i]) != 0) {
+            return 1;
+        }
+    }
+    for(size_t i = 0; i < writeDescriptors.size(); i++) {
+        Client* pClient = findClient(writeDescriptors[i]);
+        if(pClient == NULL || pClient->clientClosed || pClient->outbound.size() < pClient->receiveCapacity) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @return int descriptor of the oldest client waiting to connect, -1 (EAGAIN) if none are.
+ */
+int LoopbackTransport::acceptClient() {
+    if(m_pendingAccepts.empty()) {
+        errno = EAGAIN;
+        return -1;
+    }
+    int descriptor = m_pendingAccepts.front();
+    m_pendingAccepts.pop_front();
+    return descriptor;
+}
+
+/**
+ * Hands the server up to min(length, max read chunk) bytes the client has sent.
+ * 
+ * @return ssize_t bytes read, 0 once the client has closed, -1 on error.
+ */
+ssize_t LoopbackTransport::readFrom(int descriptor, char* buffer, size_t length) {
+    Client* pClient = findClient(descriptor);
+    if(pClient == NULL || pClient->serverClosed) {
+        errno = EBADF;
+        return -1;
+    }
+    if(pClient->inbound.empty()) {
+        if(pClient->clientClosed) {
+            return 0;
+        }
+        errno = EAGAIN;
+        return -1;
+    }
+    size_t toRead = std::min(std::min(length, m_maxReadChunk), pClient->inbound.size());
+    memcpy(buffer, pClient->inbound.data(), toRead);
+    pClient->inbound.erase(0, toRead);
+    return toRead;
+}
+
+/**
+ * Accepts up to min(length, max send chunk, free receive capacity) bytes for the client.
+ * 
+ * @return ssize_t bytes accepted, -1 (EPIPE) if the client has gone, -1 (EAGAIN) if it is full.
+ */
+ssize_t LoopbackTransport::sendTo(int descriptor, const char* data, size_t length) {
+    Client* pClient = findClient(descriptor);
+    if(pClient == NULL || pClient->serverClosed) {
+        errno = EBADF;
+        return -1;
+    }
+    if(pClient->clientClosed) {
+        errno = EPIPE;
+        return -1;
+    }
+    size_t freeCapacity = pClient->receiveCapacity - std::min(pClient->receiveCapacity, pClient->outbound.size());
+    if(freeCapacity == 0) {
+        errno = EAGAIN;
+        return -1;
+    }
+    size_t toSend = std::min(std::min(length, m_maxSendChunk), freeCapacity);
+    if(!m_discardOutput) {
+        pClient->outbound.append(data, toSend);
+    }
+    m_bytesSent += toSend;
+    return toSend;
+}
+
+int LoopbackTransport::shutdownConnection(int descriptor) {
+    Client* pClient = findClient(descriptor);
+    if(pClient == NULL || pClient->clientClosed) {
+        errno = ENOTCONN;
+        return -1;
+    }
+    pClient->clientClosed = true;
+    return 0;
+}
+
+int LoopbackTransport::closeConnection(int descriptor) {
+    Client* pClient = findClient(descriptor);
+    if(pClient == NULL || pClient->serverClosed) {
+        errno = EBADF;
+        return -1;
+    }
+    pClient->serverClosed = true;
+    return 0;
+}
+
+/**
+ * Creates a new simulated client and queues it for acceptClient().
+ * 
+ * @return int descriptor the server will see for this client.
+ */
+int LoopbackTransport::connectClient() {
+    Client client;
+    client.receiveCapacity = std::numeric_limits<size_t>::max();
+    client.clientClosed = false;
+    client.serverClosed = false;
+    m_clients.push_back(client);
+    int descriptor = kFirstClientDescriptor + (m_clients.size() - 1);
+    m_pendingAccepts.push_back(descriptor);
+    return descriptor;
+}
+
+/**
+ * Queues bytes from the client for the server to read.
+ */
+void LoopbackTransport::clientSend(int descriptor, const std::string& data) {
+    Client* pClient = findClient(descriptor);
+    if(pClient != NULL && !pClient->clientClosed) {
+        pClient->inbound.append(data);
+    }
+}
+
+/**
+ * Takes everything the server has sent the client so far, freeing its receive capacity.
+ * 
+ * @return string of the received bytes.
+ */
+std::string LoopbackTransport::clientReceive(int descriptor) {
+    std::string received;
+    Client* pClient = findClient(descriptor);
+    if(pClient != NULL) {
+        received.swap(pClient->outbound);
+    }
+    return received;
+}
+
+/**
+ * Closes the client's end; the server reads 0 once any queued input is consumed.
+ */
+void LoopbackTransport::clientClose(int descriptor) {
+    Client* pClient = findClient(descriptor);
+    if(pClient != NULL) {
+        pClient->clientClosed = true;
+    }
+}
+
+/**
+ * @return bool true until either side has closed the connection.
+ */
+bool LoopbackTransport::isClientConnected(int descriptor) {
+    Client* pClient = findClient(descriptor);
+    return pClient != NULL && !pClient->clientClosed && !pClient->serverClosed;
+}
+
+/**
+ * Limits how many bytes a single readFrom() returns, to simulate partial reads.
+ */
+void LoopbackTransport::setMaxReadChunk(size_t bytes) {
+    m_maxReadChunk = std::max(bytes, (size_t)1);
+}
+
+/**
+ * Limits how many bytes a single sendTo() accepts, to simulate partial writes.
+ */
+void LoopbackTransport::setMaxSendChunk(size_t bytes) {
+    m_maxSendChunk = std::max(bytes, (size_t)1);
+}
+
+/**
+ * Limits how much unreceived output a client holds, to simulate a slow consumer.
+ */
+void LoopbackTransport::setReceiveCapacity(int descriptor, size_t bytes) {
+    Client* pClient = findClient(descriptor);
+    if(pClient != NULL) {
+        pClient->receiveCapacity = bytes;
+    }
+}
+
+/**
+ * When true, sent bytes are counted but not kept, modelling clients that read 
+ * instantly. Keeps memory flat in benchmarks with many clients.
+ */
+void LoopbackTransport::setDiscardOutput(bool discard) {
+    m_discardOutput = discard;
+}
+
+/**
+ * @return size_t total bytes accepted by sendTo() across all clients.
+ */
+size_t LoopbackTransport::getBytesSent() {
+    return m_bytesSent;
+}
+
+LoopbackTransport::Client* LoopbackTransport::findClient(int descriptor) {
+    if(descriptor < kFirstClientDescriptor || (size_t)(descriptor - kFirstClientDescriptor) >= m_clients.size()) {
+        return NULL;
+    }
+    return &m_clients[descriptor - kFirstClientDescriptor];
+}
+
+}
@@ -0,0 +1,65 @@
+#ifndef LOOPBACKTRANSPORT_HPP_
+#define LOOPBACKTRANSPORT_HPP_
+
+#include "Transport.hpp"
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace linuxservice {
+
+class LoopbackTransport : public Transport {
+public:
+	LoopbackTransport();
+	~LoopbackTransport() = default;
+	LoopbackTransport(const LoopbackTransport&) = delete;
+	LoopbackTransport& operator=(const LoopbackTransport&) = delete;
+
+    //Transport (server side):
+    int getListenerDescriptor();
+    int pollForRead(int descriptor);
+    int pollManyForRead(const std::vector<int>& descriptors, std::vector<size_t>& readyIndexes);
+    int waitForEvents(bool includeListener, const std::vector<int>& readDescriptors, 
+        const std::vector<int>& writeDescriptors, int timeoutMs);
+    int acceptClient();
+    ssize_t readFrom(int descriptor, char* buffer, size_t length);
+    ssize_t sendTo(int descriptor, const char* data, size_t length);
+    int shutdownConnection(int descriptor);
+    int closeConnection(int descriptor);
+
+    //Simulated clients:
+    int connectClient();
+    void clientSend(int descriptor, const std::string& data);
+    std::string clientReceive(int descriptor);
+    void clientClose(int descriptor);
+    bool isClientConnected(int descriptor);
+
+    //Simulated network conditions:
+    void setMaxReadChunk(size_t bytes);
+    void setMaxSendChunk(size_t bytes);
+    void setReceiveCapacity(int descriptor, size_t bytes);
+    void setDiscardOutput(bool discard);
+    size_t getBytesSent();
+
+private:
+    struct Client {
+        std::string inbound; //client to server bytes not yet read by the server
+        std::string outbound; //server to client bytes not yet taken by clientReceive()
+        size_t receiveCapacity; //max bytes outbound may hold before sends fail with EAGAIN
+        bool clientClosed;
+        bool serverClosed;
+    };
+
+    std::vector<Client> m_clients; //indexed by descriptor - kFirstClientDescriptor
+    std::deque<int> m_pendingAccepts;
+    size_t m_maxReadChunk;
+    size_t m_maxSendChunk;
+    bool m_discardOutput;
+    size_t m_bytesSent;
+
+    Client* findClient(int descriptor);
+};
+
+}
+
+#endif /* LOOPBACKTRANSPORT_HPP_ */
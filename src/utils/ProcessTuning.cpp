@@ -0,0 +1,87 @@
+#include "ProcessTuning.hpp"
+
+#include <iostream>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace linuxservice {
+
+static const size_t kStackPrefaultBytes = 256 * 1024; //well under the default 8 MB stack
+
+/**
+ * Restricts the calling thread to one CPU, so it keeps its caches and is not 
+ * migrated mid-request.
+ * 
+ * @param cpu int index of the CPU to run on.
+ * @return bool true if the affinity was set.
+ */
+bool ProcessTuning::pinCurrentThreadToCpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    if(sched_setaffinity(0, sizeof(cpuSet), &cpuSet) < 0){
+        std::cerr << "Pinning to CPU " << cpu << " Failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+#else
+    std::cerr << "CPU affinity is not supported on this platform." << std::endl;
+    return false;
+#endif
+}
+
+/**
+ * Locks all current and future pages in RAM so the server never waits on 
+ * paging. Needs CAP_IPC_LOCK or a large enough RLIMIT_MEMLOCK.
+ * 
+ * @return bool true if memory was locked.
+ */
+bool ProcessTuning::lockAllMemory() {
+    if(mlockall(MCL_CURRENT | MCL_FUTURE) < 0){
+        std::cerr << "mlockall() Failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Touches a block of heap and stack so the pages the first requests use are 
+ * already mapped. On glibc the heap is also kept from being trimmed or served 
+ * by fresh mmap()s, so the touched pages are the ones reused later.
+ * 
+ * @param bytes size_t heap to pre-fault; the stack gets up to kStackPrefaultBytes.
+ */
+void ProcessTuning::prefaultMemory(size_t bytes) {
+#ifdef __GLIBC__
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+#endif
+    long pageSize = sysconf(_SC_PAGESIZE);
+
+    char* pHeap = static_cast<char*>(malloc(bytes));
+    if(pHeap != NULL){
+        for(size_t offset = 0; offset < bytes; offset += pageSize){
+            ((volatile char*)pHeap)[offset] = 0;
+        }
+        free(pHeap);
+    }
+
+    char stack[kStackPrefaultBytes];
+    volatile char* pStack = stack; //stores through a volatile pointer cannot be optimized away
+    size_t stackBytes = bytes < kStackPrefaultBytes ? bytes : kStackPrefaultBytes;
+    for(size_t offset = 0; offset < stackBytes; offset += pageSize){
+        pStack[offset] = 0;
+    }
+}
+
+}
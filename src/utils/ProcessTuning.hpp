@@ -0,0 +1,23 @@
+#ifndef PROCESSTUNING_HPP_
+#define PROCESSTUNING_HPP_
+
+#include <stddef.h>
+
+namespace linuxservice {
+
+/**
+ * Startup tuning for latency sensitive deployments. Each function reports 
+ * failures on stderr and returns false; the server can still run untuned.
+ */
+class ProcessTuning {
+public:
+	ProcessTuning() = delete;
+
+    static bool pinCurrentThreadToCpu(int cpu);
+    static bool lockAllMemory();
+    static void prefaultMemory(size_t bytes);
+};
+
+}
+
+#endif /* PROCESSTUNING_HPP_ */
@@ -0,0 +1,212 @@
+#include "ServerConfig.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <iostream>
+
+namespace linuxservice {
+
+/**
+ * ServerConfig holds every runtime setting of the server. Defaults match the 
+ * spec (1024 connections and backlog) and the original always-spinning loop.
+ * Settings come from an optional 'key = value' config file, then command line 
+ * overrides; see getUsage().
+ */
+ServerConfig::ServerConfig() {
+    port = -1;
+    backlog = 1024; //from spec
+    maxConnections = 1024; //from spec
+    waitStrategy = BUSY_POLL;
+    spinPasses = 10000;
+    cpuAffinity = -1;
+    busyPollMicroseconds = 0;
+    tcpNoDelay = false;
+    sendBufferBytes = 0;
+    receiveBufferBytes = 0;
+    lockMemory = false;
+    prefaultBytes = 0;
+}
+
+/**
+ * Parses 'PORT [CAPTURE_FILE] [--config FILE] [--key=value ...]'. The config 
+ * file is applied first, so --key=value options override it wherever they appear.
+ * 
+ * @return bool true if every argument was valid and a port was given.
+ */
+bool ServerConfig::parseArgs(int argc, char const *argv[]) {
+    for(int i = 1; i < argc; i++) {
+        if(std::string(argv[i]) == "--config") {
+            if(i + 1 >= argc) {
+                std::cerr << "--config takes a file path." << std::endl;
+                return false;
+            }
+            if(!loadFile(argv[i + 1])) {
+                return false;
+            }
+        }
+    }
+
+    int positional = 0;
+    for(int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if(arg == "--config") {
+            i++;
+        } else if(arg.compare(0, 2, "--") == 0) {
+            size_t equals = arg.find('=');
+            if(equals == std::string::npos) {
+                std::cerr << "Options take the form --key=value: " << arg << std::endl;
+                return false;
+            }
+            std::string key = arg.substr(2, equals - 2);
+            for(size_t j = 0; j < key.length(); j++) {
+                if(key[j] == '-') { key[j] = '_'; }
+            }
+            if(!set(key, arg.substr(equals + 1))) {
+                return false;
+            }
+        } else if(positional == 0) {
+            positional++;
+            if(!set("port", arg)) {
+                return false;
+            }
+        } else if(positional == 1) {
+            positional++;
+            captureFile = arg;
+        } else {
+            std::cerr << "Unexpected argument: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if(port < 0) {
+        std::cerr << "No 'port' argument provided." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Applies a config file of 'key = value' lines. Blank lines and '#' comments are ignored.
+ * 
+ * @return bool true if the file was read and every setting was valid.
+ */
+bool ServerConfig::loadFile(const std::string& path) {
+    std::ifstream file(path.c_str());
+    if(!file) {
+        std::cerr << "Could not open config file: " << path << std::endl;
+        return false;
+    }
+    const std::string whitespace = " \t\r";
+    std::string line;
+    int lineNumber = 0;
+    while(std::getline(file, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        if(line.find_first_not_of(whitespace) == std::string::npos) {
+            continue;
+        }
+        size_t equals = line.find('=');
+        if(equals == std::string::npos) {
+            std::cerr << path << ":" << lineNumber << ": expected 'key = value'" << std::endl;
+            return false;
+        }
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+        key.erase(0, key.find_first_not_of(whitespace));
+        key.erase(key.find_last_not_of(whitespace) + 1);
+        value.erase(0, value.find_first_not_of(whitespace));
+        value.erase(value.find_last_not_of(whitespace) + 1);
+        if(!set(key, value)) {
+            std::cerr << path << ":" << lineNumber << ": invalid setting" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Applies one setting by its config file key.
+ * 
+ * @return bool true for a known key with a valid value.
+ */
+bool ServerConfig::set(const std::string& key, const std::string& value) {
+    if(key == "capture_file") {
+        captureFile = value;
+        return true;
+    }
+    if(key == "wait_strategy") {
+        if(value == "blocking") { waitStrategy = BLOCKING; }
+        else if(value == "adaptive") { waitStrategy = ADAPTIVE; }
+        else if(value == "busy_poll") { waitStrategy = BUSY_POLL; }
+        else {
+            std::cerr << "wait_strategy is one of blocking, adaptive, busy_poll: " << value << std::endl;
+            return false;
+        }
+        return true;
+    }
+    if(key == "tcp_nodelay" || key == "lock_memory") {
+        bool flag;
+        if(value == "true" || value == "1") { flag = true; }
+        else if(value == "false" || value == "0") { flag = false; }
+        else {
+            std::cerr << key << " is true or false: " << value << std::endl;
+            return false;
+        }
+        (key == "tcp_nodelay" ? tcpNoDelay : lockMemory) = flag;
+        return true;
+    }
+
+    int* pSetting = NULL;
+    int minimum = 0;
+    if(key == "port") { pSetting = &port; }
+    else if(key == "backlog") { pSetting = &backlog; minimum = 1; }
+    else if(key == "max_connections") { pSetting = &maxConnections; minimum = 1; }
+    else if(key == "spin_passes") { pSetting = &spinPasses; }
+    else if(key == "cpu_affinity") { pSetting = &cpuAffinity; minimum = -1; }
+    else if(key == "busy_poll_us") { pSetting = &busyPollMicroseconds; }
+    else if(key == "send_buffer_bytes") { pSetting = &sendBufferBytes; }
+    else if(key == "receive_buffer_bytes") { pSetting = &receiveBufferBytes; }
+    else if(key == "prefault_bytes") { pSetting = &prefaultBytes; }
+    else {
+        std::cerr << "Unknown setting: " << key << std::endl;
+        return false;
+    }
+
+    int parsedValue;
+    try {
+        size_t parsed = 0;
+        parsedValue = std::stoi(value, &parsed);
+        if(parsed != value.length()) { throw std::invalid_argument(value); }
+    }
+    catch (const std::exception& e) {
+        std::cerr << key << " takes an integer. " << e.what() << std::endl;
+        return false;
+    }
+    if(parsedValue < minimum) {
+        std::cerr << key << " must be at least " << minimum << "." << std::endl;
+        return false;
+    }
+    *pSetting = parsedValue;
+    return true;
+}
+
+/**
+ * @return string describing the command line and every setting.
+ */
+std::string ServerConfig::getUsage() {
+    return 
+        "Usage: SingleCurrentCtLinuxService <PORT> [CAPTURE_FILE] [--config FILE] [--key=value ...]\n"
+        "Settings (config file 'key = value', or command line '--key=value'):\n"
+        "  port, capture_file\n"
+        "  backlog, max_connections               (default 1024 each)\n"
+        "  wait_strategy                          blocking | adaptive | busy_poll (default busy_poll)\n"
+        "  spin_passes                            idle passes before 'adaptive' blocks (default 10000)\n"
+        "  cpu_affinity                           CPU to pin the server thread to (default -1, unpinned)\n"
+        "  busy_poll_us                           SO_BUSY_POLL microseconds (default 0, off)\n"
+        "  tcp_nodelay                            true | false (default false)\n"
+        "  send_buffer_bytes                      SO_SNDBUF (default 0, OS default)\n"
+        "  receive_buffer_bytes                   SO_RCVBUF (default 0, OS default)\n"
+        "  lock_memory                            true | false: mlockall() at startup (default false)\n"
+        "  prefault_bytes                         heap and stack to pre-fault at startup (default 0)\n";
+}
+
+}
@@ -0,0 +1,51 @@
+#ifndef SERVERCONFIG_HPP_
+#define SERVERCONFIG_HPP_
+
+#include <string>
+
+namespace linuxservice {
+
+class ServerConfig {
+public:
+	ServerConfig();
+	~ServerConfig() = default;
+	ServerConfig(const ServerConfig&) = default;
+	ServerConfig& operator=(const ServerConfig&) = default;
+
+    enum WaitStrategy {
+        BLOCKING, //sleeps in poll() until a socket is ready: lowest CPU
+        ADAPTIVE, //spins for spinPasses idle passes, then blocks
+        BUSY_POLL //never sleeps: lowest latency, one core at 100%
+    };
+
+    //Listening and limits:
+    int port;
+    int backlog;
+    int maxConnections;
+    std::string captureFile; //empty for no capture
+
+    //Event loop:
+    WaitStrategy waitStrategy;
+    int spinPasses;
+    int cpuAffinity; //-1 leaves the server thread unpinned
+
+    //Socket options (0 keeps the OS default):
+    int busyPollMicroseconds; //SO_BUSY_POLL, Linux only
+    bool tcpNoDelay;
+    int sendBufferBytes;
+    int receiveBufferBytes;
+
+    //Memory:
+    bool lockMemory; //mlockall() at startup
+    int prefaultBytes; //heap and stack touched at startup so first requests do not page fault
+
+    bool parseArgs(int argc, char const *argv[]);
+    bool loadFile(const std::string& path);
+    bool set(const std::string& key, const std::string& value);
+
+    static std::string getUsage();
+};
+
+}
+
+#endif /* SERVERCONFIG_HPP_ */
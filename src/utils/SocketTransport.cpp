@@ -0,0 +1,139 @@
+#include "SocketTransport.hpp"
+
+#include <fcntl.h>
+#include <sys/types.h>
+
+namespace linuxservice {
+
+/**
+ * Only constructor for SocketTransport.
+ * SocketTransport is the production Transport: every call goes straight to 
+ * the matching system call on the passed TCPServer's sockets.
+ * 
+ * @param serverSocket shared ptr to a listening TCPServer instance
+ */
+SocketTransport::SocketTransport(std::shared_ptr<TCPServer> serverSocket) {
+    m_pServerSocket = serverSocket;
+}
+
+/**
+ * @return int socket descriptor of the listening server.
+ */
+int SocketTransport::getListenerDescriptor() {
+    return m_pServerSocket->getServerSocketDescriptor();
+}
+
+/**
+ * Uses poll() with a zero timeout to check a socket for waiting data or clients.
+ * 
+ * @param descriptor socket descriptor to poll.
+ * @return int -1 for error, 0 when nothing is waiting, positive when readable.
+ */
+int SocketTransport::pollForRead(int descriptor) {
+    struct pollfd entry;
+    entry.fd = descriptor;
+    entry.events = POLLIN;
+    entry.revents = 0;
+    return poll(&entry, 1, 0);
+}
+
+/**
+ * Checks every passed socket for waiting data in a single poll() with a zero 
+ * timeout, so a pass over all connections costs one system call rather than 
+ * one per connection. Unlike select(), poll() has no FD_SETSIZE limit on 
+ * descriptor values.
+ * 
+ * @param descriptors client sockets to check.
+ * @param readyIndexes cleared, then filled with the index in 'descriptors' of 
+ * every socket with data waiting, a hang-up or an error.
+ * @return int -1 for error, otherwise the number of sockets ready.
+ */
+int SocketTransport::pollManyForRead(const std::vector<int>& descriptors, std::vector<size_t>& readyIndexes) {
+    readyIndexes.clear();
+    m_pollDescriptors.resize(descriptors.size());
+    for(size_t i = 0; i < descriptors.size(); i++) {
+        m_pollDescriptors[i].fd = descriptors[i];
+        m_pollDescriptors[i].events = POLLIN;
+        m_pollDescriptors[i].revents = 0;
+    }
+    int pollReturn = poll(m_pollDescriptors.data(), m_pollDescriptors.size(), 0);
+    for(size_t i = 0; pollReturn > 0 && i < m_pollDescriptors.size() 
+        && readyIndexes.size() < (size_t)pollReturn; i++) {
+        if(m_pollDescriptors[i].revents != 0) {
+            readyIndexes.push_back(i);
+        }
+    }
+    return pollReturn;
+}
+
+/**
+ * Sleeps in poll() until the listener or one of the read descriptors has 
+ * input, one of the write descriptors can take more output, or the timeout 
+ * passes.
+ * 
+ * @param includeListener bool true to wake for clients waiting to connect.
+ * @param readDescriptors client sockets to wake for on input.
+ * @param writeDescriptors client sockets to wake for once writable.
+ * @param timeoutMs int longest sleep in milliseconds, -1 for no limit.
+ * @return int -1 for error, 0 for timeout, positive when something is ready.
+ */
+int SocketTransport::waitForEvents(bool includeListener, const std::vector<int>& readDescriptors, 
+    const std::vector<int>& writeDescriptors, int timeoutMs) {
+    m_pollDescriptors.clear();
+    struct pollfd entry;
+    entry.revents = 0;
+    if(includeListener) {
+        entry.fd = m_pServerSocket->getServerSocketDescriptor();
+        entry.events = POLLIN;
+        m_pollDescriptors.push_back(entry);
+    }
+    for(size_t i = 0; i < readDescriptors.size(); i++) {
+        entry.fd = readDescriptors[i];
+        entry.events = POLLIN;
+        m_pollDescriptors.push_back(entry);
+    }
+    for(size_t i = 0; i < writeDescriptors.size(); i++) {
+        entry.fd = writeDescriptors[i];
+        entry.events = POLLOUT;
+        m_pollDescriptors.push_back(entry);
+    }
+    return poll(m_pollDescriptors.data(), m_pollDescriptors.size(), timeoutMs);
+}
+
+/**
+ * Accepts a waiting client and makes its socket non-blocking, so a slow 
+ * client's reads and sends can never stall the server loop.
+ * 
+ * @return int descriptor of the accepted client socket, -1 for failure.
+ */
+int SocketTransport::acceptClient() {
+    struct sockaddr_in address(m_pServerSocket->getServerAddress());
+    socklen_t addrlen = sizeof(address);
+    int socketDescriptor = accept(m_pServerSocket->getServerSocketDescriptor(), (struct sockaddr *)&address, &addrlen);
+    if(socketDescriptor >= 0) {
+        int flags = fcntl(socketDescriptor, F_GETFL, 0);
+        if(flags < 0 || fcntl(socketDescriptor, F_SETFL, flags | O_NONBLOCK) < 0) {
+            close(socketDescriptor);
+            return -1;
+        }
+    }
+    return socketDescriptor;
+}
+
+ssize_t SocketTransport::readFrom(int descriptor, char* buffer, size_t length) {
+    return read(descriptor, buffer, length);
+}
+
+ssize_t SocketTransport::sendTo(int descriptor, const char* data, size_t length) {
+    return send(descriptor, data, length, 0);
+}
+
+int SocketTransport::shutdownConnection(int descriptor) {
+    return shutdown(descriptor, SHUT_RDWR);
+}
+
+int SocketTransport::closeConnection(int descriptor) {
+    return close(descriptor);
+}
+
+}
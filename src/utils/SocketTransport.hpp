@@ -0,0 +1,39 @@
+#ifndef SOCKETTRANSPORT_HPP_
+#define SOCKETTRANSPORT_HPP_
+
+#include "Transport.hpp"
+#include "TCPServer.hpp"
+#include <memory>
+#include <vector>
+#include <poll.h>
+
+namespace linuxservice {
+
+class SocketTransport : public Transport {
+public:
+	SocketTransport() = delete;
+	~SocketTransport() = default;
+	SocketTransport(const SocketTransport&) = delete;
+	SocketTransport& operator=(const SocketTransport&) = delete;
+
+    SocketTransport(std::shared_ptr<TCPServer> serverSocket);
+
+    int getListenerDescriptor();
+    int pollForRead(int descriptor);
+    int pollManyForRead(const std::vector<int>& descriptors, std::vector<size_t>& readyIndexes);
+    int waitForEvents(bool includeListener, const std::vector<int>& readDescriptors, 
+        const std::vector<int>& writeDescriptors, int timeoutMs);
+    int acceptClient();
+    ssize_t readFrom(int descriptor, char* buffer, size_t length);
+    ssize_t sendTo(int descriptor, const char* data, size_t length);
+    int shutdownConnection(int descriptor);
+    int closeConnection(int descriptor);
+
+private:
+    std::shared_ptr<TCPServer> m_pServerSocket;
+    std::vector<struct pollfd> m_pollDescriptors; //reused by every poll() so polling does not allocate
+};
+
+}
+
+#endif /* SOCKETTRANSPORT_HPP_ */
@@ -1,21 +1,35 @@
 #include "TCPServer.hpp"
+#include <netinet/tcp.h>
 
 namespace linuxservice {
 
 /**
- * Only constructor for TCPServer.
+ * Constructor for TCPServer with the default socket options.
  * TCPServer spins up a TCP server on the port provided.
  * 
  * @param port int representing server's desired port
  */
-TCPServer::TCPServer(int port) {
+TCPServer::TCPServer(int port) : TCPServer([port] { ServerConfig config; config.port = port; return config; }()) {
+}
+
+/**
+ * Constructor for TCPServer with socket options, backlog and port from a ServerConfig.
+ * TCPServer spins up a TCP server on the configured port.
+ * 
+ * @param config ServerConfig holding the port and socket settings
+ */
+TCPServer::TCPServer(const ServerConfig& config) {
     m_domain = AF_INET; //AF_INET(IPv4) or AF_INET6(IPv6)
     m_commType = SOCK_STREAM; //SOCK_STREAM(TCP), UDP would be SOCK_DGRAM
     m_protocolVal = 0; //always "0" for IP
-    m_port = port;
-    m_maxSocketsWaitingToConnect = 1024; //from spec
+    m_port = config.port;
+    m_maxSocketsWaitingToConnect = config.backlog; //1024 from spec unless configured
     //Socket Options values:
     m_reuseAddrSocketOption = 1; //a zero value disables this socket option
+    m_noDelaySocketOption = config.tcpNoDelay ? 1 : 0;
+    m_busyPollSocketOption = config.busyPollMicroseconds;
+    m_sendBufferSocketOption = config.sendBufferBytes;
+    m_receiveBufferSocketOption = config.receiveBufferBytes;
     //Fill custom 'netinet/in.h' struct:
     m_address.sin_family = m_domain; //always the AF_INET domain family
     m_address.sin_addr.s_addr = INADDR_ANY; //localhost address, can accept both UDP and TCP
@@ -35,6 +49,10 @@ TCPServer::TCPServer(int port) {
         std::cerr << "Setting Server Socket Options Failure: " << strerror(errno) << std::endl; 
         exit(EXIT_FAILURE); 
     }
+    //Client options are set once on the listener; Linux copies them to every socket accept() returns
+    if (!applyClientSocketOptions(m_serverSocketDescriptor)) {
+        exit(EXIT_FAILURE); 
+    }
 
     //Step 3: binding the socket to the address & port
     if (bind(m_serverSocketDescriptor, (struct sockaddr *)&m_address, sizeof(m_address)) < 0) { 
@@ -67,4 +85,45 @@ struct sockaddr_in TCPServer::getServerAddress(){
     return m_address;
 }
 
-}
\ No newline at end of file
+/**
+ * Sets the configured TCP_NODELAY, SO_BUSY_POLL, SO_SNDBUF and SO_RCVBUF 
+ * options on the listening socket, for accepted client sockets to inherit. 
+ * Options left at zero are not touched.
+ * 
+ * @param socketDescriptor int listening socket descriptor to tune
+ * @return bool true if every configured option was set
+ */
+bool TCPServer::applyClientSocketOptions(int socketDescriptor) {
+    //TCP_NODELAY - sends small replies immediately instead of coalescing them (Nagle's algorithm)
+    if (m_noDelaySocketOption && setsockopt(socketDescriptor, IPPROTO_TCP, TCP_NODELAY, 
+        &m_noDelaySocketOption, sizeof(m_noDelaySocketOption))) {
+        std::cerr << "Setting TCP_NODELAY Failure: " << strerror(errno) << std::endl;
+        return false;
+    }
+    //SO_BUSY_POLL - busy polls the device queue for up to this many microseconds when this socket has no data
+    if (m_busyPollSocketOption) {
+#ifdef SO_BUSY_POLL
+        if (setsockopt(socketDescriptor, SOL_SOCKET, SO_BUSY_POLL, 
+            &m_busyPollSocketOption, sizeof(m_busyPollSocketOption))) {
+            std::cerr << "Setting SO_BUSY_POLL Failure: " << strerror(errno) << std::endl;
+            return false;
+        }
+#else
+        std::cerr << "SO_BUSY_POLL is not supported on this platform." << std::endl;
+        return false;
+#endif
+    }
+    if (m_sendBufferSocketOption && setsockopt(socketDescriptor, SOL_SOCKET, SO_SNDBUF, 
+        &m_sendBufferSocketOption, sizeof(m_sendBufferSocketOption))) {
+        std::cerr << "Setting SO_SNDBUF Failure: " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (m_receiveBufferSocketOption && setsockopt(socketDescriptor, SOL_SOCKET, SO_RCVBUF, 
+        &m_receiveBufferSocketOption, sizeof(m_receiveBufferSocketOption))) {
+        std::cerr << "Setting SO_RCVBUF Failure: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
@@ -1,12 +1,14 @@
 #ifndef TCPSERVER_HPP_
 #define TCPSERVER_HPP_
 
+#include "ServerConfig.hpp"
 #include <iostream>
 
 #include <unistd.h> 
 #include <stdio.h> 
 #include <sys/socket.h> 
 #include <stdlib.h> 
+#include <string.h>
 #include <netinet/in.h> 
 
 namespace linuxservice {
@@ -19,6 +21,7 @@ public:
 	TCPServer& operator=(const TCPServer&) = delete;
 
     TCPServer(int port);
+    TCPServer(const ServerConfig& config);
 
     int getServerSocketDescriptor();
     struct sockaddr_in getServerAddress();
@@ -34,6 +37,12 @@ private:
 
     //Socket Option Values:
     int m_reuseAddrSocketOption;
+    int m_noDelaySocketOption; //TCP_NODELAY
+    int m_busyPollSocketOption; //SO_BUSY_POLL microseconds, zero leaves it unset
+    int m_sendBufferSocketOption; //SO_SNDBUF bytes, zero leaves the OS default
+    int m_receiveBufferSocketOption; //SO_RCVBUF bytes, zero leaves the OS default
+
+    bool applyClientSocketOptions(int socketDescriptor);
 };
 
 }
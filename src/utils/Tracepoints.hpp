@@ -0,0 +1,37 @@
+#ifndef TRACEPOINTS_HPP_
+#define TRACEPOINTS_HPP_
+
+/*
+ * USDT (sys/sdt.h) static tracepoints on the request lifecycle, under the 
+ * 'singlecurrentct' provider. An unattached probe is a single nop in the 
+ * binary. Building with -DSCC_TRACEPOINTS=OFF, or without sys/sdt.h, 
+ * compiles them out entirely.
+ * 
+ * Probes and their arguments:
+ *   accept(fd)                          new client accepted
+ *   read(fd, bytes)                     bytes read from a client
+ *   command_parsed(fd, command)         CountAPI::InputCommand value
+ *   count_applied(fd, delta, count)     count changed by delta, now count
+ *   reply_queued(fd, bytes)             reply handed to the sender only
+ *   broadcast_start(connections, bytes) fan-out of one message begins
+ *   broadcast_end(connections, failed)  fan-out done, failed sends counted
+ *   command_done(fd, command)           one command's reply fully sent, or its 
+ *                                       broadcast queued to every connection
+ *   connection_close(fd)                client removed from connections
+ * 
+ * Example bpftrace scripts are in scripts/bpftrace.
+ */
+
+#ifdef SCC_TRACEPOINTS_ENABLED
+#include <sys/sdt.h>
+#define SCC_TRACE1(probe, a1) DTRACE_PROBE1(singlecurrentct, probe, a1)
+#define SCC_TRACE2(probe, a1, a2) DTRACE_PROBE2(singlecurrentct, probe, a1, a2)
+#define SCC_TRACE3(probe, a1, a2, a3) DTRACE_PROBE3(singlecurrentct, probe, a1, a2, a3)
+#else
+//Name the arguments inside an unevaluated sizeof so values computed only for a probe do not warn as unused
+#define SCC_TRACE1(probe, a1) do { (void)sizeof(a1); } while(0)
+#define SCC_TRACE2(probe, a1, a2) do { (void)sizeof(a1); (void)sizeof(a2); } while(0)
+#define SCC_TRACE3(probe, a1, a2, a3) do { (void)sizeof(a1); (void)sizeof(a2); (void)sizeof(a3); } while(0)
+#endif
+
+#endif /* TRACEPOINTS_HPP_ */
@@ -0,0 +1,201 @@
+#include "TrafficCapture.hpp"
+#include <iostream>
+#include <string.h>
+#include <errno.h>
+
+namespace linuxservice {
+
+//File layout: 8 byte magic, then back to back records of
+//[uint64 timestampNs][uint32 connectionId][uint32 type][uint32 length][length bytes], in host byte order.
+static const char kCaptureMagic[8] = {'S', 'C', 'C', 'C', 'A', 'P', '0', '2'};
+static const size_t kRecordHeaderSize = sizeof(uint64_t) + 3 * sizeof(uint32_t);
+static const size_t kFlushThreshold = 64 * 1024; //wakes the writer early once this much is queued
+
+/**
+ * Only constructor for TrafficCapture.
+ * TrafficCapture appends every recorded command, accept and close to a 
+ * compact binary file. 
+ * Records are queued in memory by record() and written out by a background 
+ * thread, so the server loop never blocks on disk I/O.
+ * 
+ * @param capturePath path of the capture file; an existing file is truncated.
+ */
+TrafficCapture::TrafficCapture(const std::string& capturePath) {
+    m_start = std::chrono::steady_clock::now();
+    m_stopping = false;
+    m_activeBuffer.reserve(kFlushThreshold * 2);
+    m_writeBuffer.reserve(kFlushThreshold * 2);
+
+    if((m_pFile = fopen(capturePath.c_str(), "wb")) == NULL) {
+        std::cerr << "Capture File Open Failure: " << strerror(errno) << std::endl;
+        return;
+    }
+    fwrite(kCaptureMagic, 1, sizeof(kCaptureMagic), m_pFile);
+    m_writer = std::thread(&TrafficCapture::writerLoop, this);
+}
+
+/**
+ * Stops the writer thread once everything queued has been written, then closes the file.
+ */
+TrafficCapture::~TrafficCapture() {
+    if(m_pFile == NULL) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_bufferMutex);
+        m_stopping = true;
+    }
+    m_bufferReady.notify_one();
+    m_writer.join();
+    fclose(m_pFile);
+}
+
+/**
+ * Getter for whether the capture file was opened successfully.
+ * 
+ * @return bool true when records will be written.
+ */
+bool TrafficCapture::isOpen() {
+    return m_pFile != NULL;
+}
+
+/**
+ * Queues one inbound command for writing. Only copies into memory; the 
+ * background writer does the disk I/O.
+ * 
+ * @param connectionId id of the connection the data was read from.
+ * @param data bytes exactly as read from the connection.
+ * @param length number of bytes in data.
+ */
+void TrafficCapture::record(uint32_t connectionId, const char* data, uint32_t length) {
+    append(DATA, connectionId, data, length);
+}
+
+/**
+ * Queues a data-less record of a connection being accepted or closed, so 
+ * replay can reopen connections that never sent anything.
+ * 
+ * @param connectionId id of the connection.
+ * @param type ACCEPT or CLOSE.
+ */
+void TrafficCapture::recordEvent(uint32_t connectionId, RecordType type) {
+    append(type, connectionId, NULL, 0);
+}
+
+/**
+ * Helper for 'record' and 'recordEvent'. Stamps and queues one record.
+ */
+void TrafficCapture::append(RecordType type, uint32_t connectionId, const char* data, uint32_t length) {
+    if(m_pFile == NULL) {
+        return;
+    }
+    uint64_t timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_start).count();
+    uint32_t typeValue = type;
+    char header[kRecordHeaderSize];
+    char* pField = header;
+    memcpy(pField, &timestampNs, sizeof(timestampNs));
+    pField += sizeof(timestampNs);
+    memcpy(pField, &connectionId, sizeof(connectionId));
+    pField += sizeof(connectionId);
+    memcpy(pField, &typeValue, sizeof(typeValue));
+    pField += sizeof(typeValue);
+    memcpy(pField, &length, sizeof(length));
+
+    bool wakeWriter;
+    {
+        std::lock_guard<std::mutex> lock(m_bufferMutex);
+        m_activeBuffer.insert(m_activeBuffer.end(), header, header + kRecordHeaderSize);
+        if(length > 0) {
+            m_activeBuffer.insert(m_activeBuffer.end(), data, data + length);
+        }
+        wakeWriter = m_activeBuffer.size() >= kFlushThreshold;
+    }
+    if(wakeWriter) {
+        m_bufferReady.notify_one();
+    }
+}
+
+/**
+ * Background thread body. Swaps the queued records out from under the server 
+ * loop and writes them, either when enough has queued or every 100ms.
+ */
+void TrafficCapture::writerLoop() {
+    std::unique_lock<std::mutex> lock(m_bufferMutex);
+    while(true) {
+        m_bufferReady.wait_for(lock, std::chrono::milliseconds(100), [this] {
+            return m_stopping || m_activeBuffer.size() >= kFlushThreshold;
+        });
+        bool stopping = m_stopping;
+        m_writeBuffer.swap(m_activeBuffer);
+        lock.unlock();
+
+        if(!m_writeBuffer.empty()) {
+            if(fwrite(m_writeBuffer.data(), 1, m_writeBuffer.size(), m_pFile) != m_writeBuffer.size()) {
+                std::cerr << "Capture File Write Failure: " << strerror(errno) << std::endl;
+            }
+            fflush(m_pFile);
+            m_writeBuffer.clear();
+        }
+
+        lock.lock();
+        if(stopping && m_activeBuffer.empty()) {
+            return;
+        }
+    }
+}
+
+/**
+ * Reads back every record of a capture file written by TrafficCapture.
+ * 
+ * @param[in] capturePath path of the capture file.
+ * @param[out] records records in the order they were captured.
+ * @return bool true if the file was a capture and read completely, false otherwise.
+ */
+bool TrafficCapture::readCapture(const std::string& capturePath, std::vector<Record>& records) {
+    FILE* pFile;
+    if((pFile = fopen(capturePath.c_str(), "rb")) == NULL) {
+        std::cerr << "Capture File Open Failure: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    char magic[sizeof(kCaptureMagic)];
+    if(fread(magic, 1, sizeof(magic), pFile) != sizeof(magic) || memcmp(magic, kCaptureMagic, sizeof(magic)) != 0) {
+        std::cerr << "Not a capture file: " << capturePath << std::endl;
+        fclose(pFile);
+        return false;
+    }
+
+    bool complete = true;
+    char header[kRecordHeaderSize];
+    while(fread(header, 1, kRecordHeaderSize, pFile) == kRecordHeaderSize) {
+        Record record;
+        uint32_t typeValue;
+        uint32_t length;
+        const char* pField = header;
+        memcpy(&record.timestampNs, pField, sizeof(record.timestampNs));
+        pField += sizeof(record.timestampNs);
+        memcpy(&record.connectionId, pField, sizeof(record.connectionId));
+        pField += sizeof(record.connectionId);
+        memcpy(&typeValue, pField, sizeof(typeValue));
+        pField += sizeof(typeValue);
+        memcpy(&length, pField, sizeof(length));
+        if(typeValue > CLOSE) {
+            std::cerr << "Capture file has a record of unknown type " << typeValue << "." << std::endl;
+            complete = false;
+            break;
+        }
+        record.type = static_cast<RecordType>(typeValue);
+        record.data.resize(length);
+        if(length > 0 && fread(&record.data[0], 1, length, pFile) != length) {
+            std::cerr << "Capture file ends in a truncated record." << std::endl;
+            complete = false;
+            break;
+        }
+        records.push_back(record);
+    }
+    fclose(pFile);
+    return complete;
+}
+
+}
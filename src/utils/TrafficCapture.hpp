@@ -0,0 +1,59 @@
+#ifndef TRAFFICCAPTURE_HPP_
+#define TRAFFICCAPTURE_HPP_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace linuxservice {
+
+class TrafficCapture {
+public:
+	TrafficCapture() = delete;
+	~TrafficCapture();
+	TrafficCapture(const TrafficCapture&) = delete;
+	TrafficCapture& operator=(const TrafficCapture&) = delete;
+
+    TrafficCapture(const std::string& capturePath);
+
+    enum RecordType : uint32_t {
+        DATA = 0, //bytes read from the connection
+        ACCEPT = 1, //connection accepted; carries no data
+        CLOSE = 2 //connection closed; carries no data
+    };
+
+    struct Record {
+        uint64_t timestampNs; //nanoseconds since the capture was opened
+        uint32_t connectionId;
+        RecordType type;
+        std::string data;
+    };
+
+    bool isOpen();
+    void record(uint32_t connectionId, const char* data, uint32_t length);
+    void recordEvent(uint32_t connectionId, RecordType type);
+
+    static bool readCapture(const std::string& capturePath, std::vector<Record>& records);
+
+private:
+    FILE* m_pFile;
+    std::chrono::steady_clock::time_point m_start;
+    std::vector<char> m_activeBuffer; //filled by record() on the server loop
+    std::vector<char> m_writeBuffer; //drained to disk by m_writer
+    std::mutex m_bufferMutex;
+    std::condition_variable m_bufferReady;
+    bool m_stopping;
+    std::thread m_writer;
+
+    void append(RecordType type, uint32_t connectionId, const char* data, uint32_t length);
+    void writerLoop();
+};
+
+}
+
+#endif /* TRAFFICCAPTURE_HPP_ */
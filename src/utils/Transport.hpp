@@ -0,0 +1,34 @@
+#ifndef TRANSPORT_HPP_
+#define TRANSPORT_HPP_
+
+#include <sys/types.h>
+#include <vector>
+
+namespace linuxservice {
+
+/**
+ * Socket operations used by ConnectionManager. Implementations mirror the 
+ * matching system calls: failures return -1 and set errno.
+ */
+class Transport {
+public:
+	Transport() = default;
+	virtual ~Transport() = default;
+	Transport(const Transport&) = delete;
+	Transport& operator=(const Transport&) = delete;
+
+    virtual int getListenerDescriptor() = 0;
+    virtual int pollForRead(int descriptor) = 0;
+    virtual int pollManyForRead(const std::vector<int>& descriptors, std::vector<size_t>& readyIndexes) = 0;
+    virtual int waitForEvents(bool includeListener, const std::vector<int>& readDescriptors, 
+        const std::vector<int>& writeDescriptors, int timeoutMs) = 0;
+    virtual int acceptClient() = 0;
+    virtual ssize_t readFrom(int descriptor, char* buffer, size_t length) = 0;
+    virtual ssize_t sendTo(int descriptor, const char* data, size_t length) = 0;
+    virtual int shutdownConnection(int descriptor) = 0;
+    virtual int closeConnection(int descriptor) = 0;
+};
+
+}
+
+#endif /* TRANSPORT_HPP_ */
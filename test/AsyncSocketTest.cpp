@@ -0,0 +1,83 @@
+#include "AsyncSocketTest.hpp"
+#include "../src/utils/AsyncSocket.hpp"
+#include "../src/utils/LoopbackTransport.hpp"
+#include <iostream>
+#include <string>
+
+int main() {
+    linuxservice::AsyncSocketTest testSet;
+    testSet.runTests();
+    return 0;
+}
+
+namespace linuxservice {
+
+void AsyncSocketTest::runTests(){
+    //Add tests here:
+    m_testResults.push_back(AsyncSocketTest::Test1_SteadyBacklog_OutboundStaysBounded());
+    m_testResults.push_back(AsyncSocketTest::Test2_OverlongLineAcrossReads_RejectedAndDiscarded());
+    //DO LAST:
+    evaluateTests();
+}
+
+ExecutableTestUtil::TestStatus AsyncSocketTest::Test1_SteadyBacklog_OutboundStaysBounded(){
+    std::cout << "Starting Test1_SteadyBacklog_OutboundStaysBounded..." << std::endl;
+    
+    LoopbackTransport transport;
+    transport.connectClient();
+    int descriptor = transport.acceptClient();
+    AsyncSocket socket(&transport, descriptor);
+    std::string message(37, 'x');
+    transport.setReceiveCapacity(descriptor, message.length());
+
+    //one message stays queued behind the one the client is holding, so output never fully drains
+    socket.queue(message + message);
+    for(int i = 0; i < 100000; i++){ //Input Command Under Test
+        transport.clientReceive(descriptor);
+        socket.queue(message);
+    }
+
+    if(socket.isClosed() || !socket.hasPendingOutput()){
+        std::cerr << "Test1: FAIL - A backlog of one message should neither drain nor drop the client." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(socket.getOutboundBufferSize() > 64 * 1024){
+        std::cerr << "Test1: FAIL - Outbound buffer grew to " << socket.getOutboundBufferSize() 
+            << " bytes for a " << message.length() << " byte backlog." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test1: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus AsyncSocketTest::Test2_OverlongLineAcrossReads_RejectedAndDiscarded(){
+    std::cout << "Starting Test2_OverlongLineAcrossReads_RejectedAndDiscarded..." << std::endl;
+    
+    LoopbackTransport transport;
+    AsyncSocket socket(&transport, 4);
+    std::string junk(800, 'x');
+    socket.receive(junk.data(), junk.length());
+    socket.receive(junk.data(), junk.length());
+    std::string rest = "INCR 5\r\nOUTPUT\r\n";
+    socket.receive(rest.data(), rest.length()); //Input Command Under Test
+
+    std::string line = "unset";
+    AsyncSocket::ReadLineAwaiter rejected = socket.read_line(line);
+    if(!rejected.await_ready() || !rejected.await_resume() || !line.empty()){
+        std::cerr << "Test2: FAIL - Overlong line was not handed over as an empty line." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    AsyncSocket::ReadLineAwaiter next = socket.read_line(line);
+    if(!next.await_ready() || !next.await_resume() || line != "OUTPUT\r\n"){
+        std::cerr << "Test2: FAIL - Tail of the overlong line was not discarded, got '" << line << "'." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test2: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+}
@@ -0,0 +1,24 @@
+#ifndef ASYNCSOCKETTEST_HPP_
+#define ASYNCSOCKETTEST_HPP_
+
+#include "utils/ExecutableTestUtil.hpp"
+
+namespace linuxservice {
+
+class AsyncSocketTest : public ExecutableTestUtil {
+public:
+	AsyncSocketTest() = default;
+	~AsyncSocketTest() = default;
+	AsyncSocketTest(const AsyncSocketTest&) = delete;
+	AsyncSocketTest& operator=(const AsyncSocketTest&) = delete;
+
+	void runTests();
+
+private:
+	static ExecutableTestUtil::TestStatus Test1_SteadyBacklog_OutboundStaysBounded();
+    static ExecutableTestUtil::TestStatus Test2_OverlongLineAcrossReads_RejectedAndDiscarded();
+};
+
+}
+
+#endif /* ASYNCSOCKETTEST_HPP_ */
@@ -0,0 +1,410 @@
+#include "ConnectionManagerTest.hpp"
+#include "../src/utils/ConnectionManager.hpp"
+#include "../src/utils/ConnectionTask.hpp"
+#include "../src/utils/CountAPI.hpp"
+#include "../src/utils/LoopbackTransport.hpp"
+#include <iostream>
+#include <string>
+
+int main() {
+    linuxservice::ConnectionManagerTest testSet;
+    testSet.runTests();
+    return 0;
+}
+
+namespace linuxservice {
+
+static const std::string kGreeting = "---Connection Accepted---\r\n";
+
+void ConnectionManagerTest::runTests(){
+    //Add tests here:
+    m_testResults.push_back(ConnectionManagerTest::Test1_Accept_SendsGreeting());
+    m_testResults.push_back(ConnectionManagerTest::Test2_INCR_BroadcastsToAllConnections());
+    m_testResults.push_back(ConnectionManagerTest::Test3_OUTPUT_RepliesOnlyToSender());
+    m_testResults.push_back(ConnectionManagerTest::Test4_ClientClose_RemovesConnection());
+    m_testResults.push_back(ConnectionManagerTest::Test5_PartialWrites_DeliverWholeReply());
+    m_testResults.push_back(ConnectionManagerTest::Test6_SlowConsumer_OthersStillReceive());
+    m_testResults.push_back(ConnectionManagerTest::Test7_MaxConnections_LeavesClientsWaiting());
+    m_testResults.push_back(ConnectionManagerTest::Test8_PartialReads_AssembleWholeCommand());
+    m_testResults.push_back(ConnectionManagerTest::Test9_PipelinedCommands_EachHandled());
+    m_testResults.push_back(ConnectionManagerTest::Test10_ConnectionChurn_ReusesHandlerFrames());
+    m_testResults.push_back(ConnectionManagerTest::Test11_IdlePass_ReportsNoWork());
+    m_testResults.push_back(ConnectionManagerTest::Test12_OverlongLine_RejectedNotSplit());
+    m_testResults.push_back(ConnectionManagerTest::Test13_WriteBlockedClientSending_ReportsNoWork());
+    m_testResults.push_back(ConnectionManagerTest::Test14_BacklogDuringBroadcasts_DeliveredWholeAndInOrder());
+    //DO LAST:
+    evaluateTests();
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test1_Accept_SendsGreeting(){
+    std::cout << "Starting Test1_Accept_SendsGreeting..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int client = pTransport->connectClient();
+    manager.handleConnections();
+
+    if(manager.getConnectionCount() != 1){
+        std::cerr << "Test1: FAIL - Did not accept the waiting client." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(pTransport->clientReceive(client) != kGreeting){
+        std::cerr << "Test1: FAIL - Client did not receive the greeting." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test1: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test2_INCR_BroadcastsToAllConnections(){
+    std::cout << "Starting Test2_INCR_BroadcastsToAllConnections..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int sender = pTransport->connectClient();
+    int listener = pTransport->connectClient();
+    manager.handleConnections();
+    manager.handleConnections();
+    pTransport->clientReceive(sender);
+    pTransport->clientReceive(listener);
+
+    pTransport->clientSend(sender, "INCR 5\r\n"); //Input Command Under Test
+    manager.handleConnections();
+
+    std::string senderReceived = pTransport->clientReceive(sender);
+    if(senderReceived.find("Current Count: 5") == std::string::npos || pTransport->clientReceive(listener) != senderReceived){
+        std::cerr << "Test2: FAIL - INCR result was not broadcast to every connection." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test2: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test3_OUTPUT_RepliesOnlyToSender(){
+    std::cout << "Starting Test3_OUTPUT_RepliesOnlyToSender..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int sender = pTransport->connectClient();
+    int listener = pTransport->connectClient();
+    manager.handleConnections();
+    manager.handleConnections();
+    pTransport->clientReceive(sender);
+    pTransport->clientReceive(listener);
+
+    pTransport->clientSend(sender, "OUTPUT\r\n"); //Input Command Under Test
+    manager.handleConnections();
+
+    if(pTransport->clientReceive(sender) != "Current Count: 0\r\n"){
+        std::cerr << "Test3: FAIL - Sender did not receive the count." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(!pTransport->clientReceive(listener).empty()){
+        std::cerr << "Test3: FAIL - OUTPUT reply reached another connection." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test3: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test4_ClientClose_RemovesConnection(){
+    std::cout << "Starting Test4_ClientClose_RemovesConnection..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int client = pTransport->connectClient();
+    manager.handleConnections();
+
+    pTransport->clientClose(client);
+    manager.handleConnections();
+
+    if(manager.getConnectionCount() != 0){
+        std::cerr << "Test4: FAIL - Closed client was kept as a connection." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test4: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test5_PartialWrites_DeliverWholeReply(){
+    std::cout << "Starting Test5_PartialWrites_DeliverWholeReply..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    pTransport->setMaxSendChunk(3);
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int client = pTransport->connectClient();
+    manager.handleConnections();
+
+    if(pTransport->clientReceive(client) != kGreeting){
+        std::cerr << "Test5: FAIL - Greeting was cut short by partial writes." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    pTransport->clientSend(client, "OUTPUT\r\n"); //Input Command Under Test
+    manager.handleConnections();
+
+    if(pTransport->clientReceive(client) != "Current Count: 0\r\n"){
+        std::cerr << "Test5: FAIL - Reply was cut short by partial writes." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test5: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test6_SlowConsumer_OthersStillReceive(){
+    std::cout << "Starting Test6_SlowConsumer_OthersStillReceive..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int slow = pTransport->connectClient();
+    int sender = pTransport->connectClient();
+    manager.handleConnections();
+    manager.handleConnections();
+    pTransport->clientReceive(sender);
+    pTransport->setReceiveCapacity(slow, kGreeting.length()); //greeting is never taken, so it is full
+
+    pTransport->clientSend(sender, "INCR 1\r\n"); //Input Command Under Test
+    manager.handleConnections();
+
+    if(pTransport->clientReceive(sender).find("Current Count: 1") == std::string::npos){
+        std::cerr << "Test6: FAIL - Slow consumer stopped the broadcast to others." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(pTransport->clientReceive(slow) != kGreeting){
+        std::cerr << "Test6: FAIL - Slow consumer was sent more than it could hold." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test6: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test7_MaxConnections_LeavesClientsWaiting(){
+    std::cout << "Starting Test7_MaxConnections_LeavesClientsWaiting..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    manager.setMaxConnections(2);
+    for(int i = 0; i < 3; i++){
+        pTransport->connectClient();
+    }
+    for(int i = 0; i < 3; i++){
+        manager.handleConnections();
+    }
+
+    if(manager.getConnectionCount() != 2){
+        std::cerr << "Test7: FAIL - Accepted past the connection limit." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test7: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test8_PartialReads_AssembleWholeCommand(){
+    std::cout << "Starting Test8_PartialReads_AssembleWholeCommand..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    pTransport->setMaxReadChunk(3);
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int client = pTransport->connectClient();
+    manager.handleConnections();
+    pTransport->clientReceive(client);
+
+    pTransport->clientSend(client, "OUTPUT\r\n"); //Input Command Under Test
+    for(int i = 0; i < 3; i++){
+        manager.handleConnections();
+    }
+
+    if(pTransport->clientReceive(client) != "Current Count: 0\r\n"){
+        std::cerr << "Test8: FAIL - Command split across reads was not handled as one." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test8: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test9_PipelinedCommands_EachHandled(){
+    std::cout << "Starting Test9_PipelinedCommands_EachHandled..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int client = pTransport->connectClient();
+    manager.handleConnections();
+    pTransport->clientReceive(client);
+
+    pTransport->clientSend(client, "INCR 2\r\nINCR 3\r\nOUTPUT\r\n"); //Input Command Under Test
+    manager.handleConnections();
+
+    std::string received = pTransport->clientReceive(client);
+    if(received.find("Current Count: 5\r\n") == std::string::npos){
+        std::cerr << "Test9: FAIL - Commands sharing one read were not all handled." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test9: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test10_ConnectionChurn_ReusesHandlerFrames(){
+    std::cout << "Starting Test10_ConnectionChurn_ReusesHandlerFrames..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    size_t blocksAfterFirst = 0;
+    for(int i = 0; i < 100; i++){
+        int client = pTransport->connectClient();
+        manager.handleConnections();
+        pTransport->clientClose(client);
+        manager.handleConnections();
+        if(i == 0){
+            blocksAfterFirst = FramePool::getBlocksAllocated();
+        }
+    }
+
+    if(manager.getConnectionCount() != 0 || FramePool::getBlocksAllocated() != blocksAfterFirst){
+        std::cerr << "Test10: FAIL - Handler frames were not recycled." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test10: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test11_IdlePass_ReportsNoWork(){
+    std::cout << "Starting Test11_IdlePass_ReportsNoWork..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int client = pTransport->connectClient();
+
+    if(!manager.handleConnections()){
+        std::cerr << "Test11: FAIL - Accepting a client was not reported as work." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(manager.handleConnections()){
+        std::cerr << "Test11: FAIL - A pass with nothing to do was reported as work." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    pTransport->clientSend(client, "OUTPUT\r\n"); //Input Command Under Test
+    if(!manager.handleConnections()){
+        std::cerr << "Test11: FAIL - Handling a command was not reported as work." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test11: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test12_OverlongLine_RejectedNotSplit(){
+    std::cout << "Starting Test12_OverlongLine_RejectedNotSplit..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int client = pTransport->connectClient();
+    manager.handleConnections();
+    pTransport->clientReceive(client);
+
+    pTransport->clientSend(client, std::string(1100, ' ') + "INCR 5\r\nOUTPUT\r\n"); //Input Command Under Test
+    manager.handleConnections(); //longer than one read, so it takes two passes
+    manager.handleConnections();
+
+    std::string received = pTransport->clientReceive(client);
+    if(received.find("Not a command handled by the server.\r\n") == std::string::npos){
+        std::cerr << "Test12: FAIL - Overlong line was not rejected." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(received.find("Current Count: 0\r\n") == std::string::npos){
+        std::cerr << "Test12: FAIL - Tail of an overlong line was handled as a command." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test12: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test13_WriteBlockedClientSending_ReportsNoWork(){
+    std::cout << "Starting Test13_WriteBlockedClientSending_ReportsNoWork..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int client = pTransport->connectClient();
+    manager.handleConnections();
+    pTransport->clientReceive(client);
+    pTransport->setReceiveCapacity(client, 27); //room for one reply and half of another
+
+    //the second reply does not fit, so the handler blocks on its write with more input waiting
+    pTransport->clientSend(client, "OUTPUT\r\nOUTPUT\r\n");
+    manager.handleConnections();
+    pTransport->clientSend(client, "OUTPUT\r\n"); //Input Command Under Test
+
+    for(int i = 0; i < 3; i++){
+        if(manager.handleConnections()){
+            std::cerr << "Test13: FAIL - Unread input from a write-blocked client was reported as work." << std::endl;
+            return ExecutableTestUtil::TestStatus::FAILED;
+        }
+    }
+
+    pTransport->clientReceive(client);
+    if(!manager.handleConnections()){
+        std::cerr << "Test13: FAIL - Unblocking the write was not reported as work." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test13: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ConnectionManagerTest::Test14_BacklogDuringBroadcasts_DeliveredWholeAndInOrder(){
+    std::cout << "Starting Test14_BacklogDuringBroadcasts_DeliveredWholeAndInOrder..." << std::endl;
+    
+    std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+    ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+    int slow = pTransport->connectClient();
+    int sender = pTransport->connectClient();
+    manager.handleConnections();
+    manager.handleConnections();
+    pTransport->clientReceive(slow);
+    pTransport->clientReceive(sender);
+    pTransport->setReceiveCapacity(slow, 10); //the first broadcast only partly fits
+
+    pTransport->clientSend(sender, "INCR 1\r\n"); //Input Command Under Test
+    manager.handleConnections();
+    std::string slowReceived = pTransport->clientReceive(slow); //room frees up behind the backlog
+    pTransport->clientSend(sender, "INCR 2\r\n");
+    manager.handleConnections();
+    pTransport->setReceiveCapacity(slow, 1024);
+    manager.handleConnections();
+    pTransport->clientSend(sender, "DECR 1\r\n"); //sent once the backlog has drained
+    manager.handleConnections();
+    slowReceived += pTransport->clientReceive(slow);
+
+    std::string expected = "Increased by 1 (Current Count: 1)\r\nIncreased by 2 (Current Count: 3)\r\n"
+        "Decreased by 1 (Current Count: 2)\r\n";
+    if(slowReceived != expected){
+        std::cerr << "Test14: FAIL - Backlogged client's broadcasts were cut short or reordered." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(pTransport->clientReceive(sender) != expected){
+        std::cerr << "Test14: FAIL - Sender did not receive every broadcast." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test14: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+}
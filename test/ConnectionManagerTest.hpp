@@ -0,0 +1,36 @@
+#ifndef CONNECTIONMANAGERTEST_HPP_
+#define CONNECTIONMANAGERTEST_HPP_
+
+#include "utils/ExecutableTestUtil.hpp"
+
+namespace linuxservice {
+
+class ConnectionManagerTest : public ExecutableTestUtil {
+public:
+	ConnectionManagerTest() = default;
+	~ConnectionManagerTest() = default;
+	ConnectionManagerTest(const ConnectionManagerTest&) = delete;
+	ConnectionManagerTest& operator=(const ConnectionManagerTest&) = delete;
+
+	void runTests();
+
+private:
+	static ExecutableTestUtil::TestStatus Test1_Accept_SendsGreeting();
+    static ExecutableTestUtil::TestStatus Test2_INCR_BroadcastsToAllConnections();
+	static ExecutableTestUtil::TestStatus Test3_OUTPUT_RepliesOnlyToSender();
+    static ExecutableTestUtil::TestStatus Test4_ClientClose_RemovesConnection();
+    static ExecutableTestUtil::TestStatus Test5_PartialWrites_DeliverWholeReply();
+    static ExecutableTestUtil::TestStatus Test6_SlowConsumer_OthersStillReceive();
+    static ExecutableTestUtil::TestStatus Test7_MaxConnections_LeavesClientsWaiting();
+    static ExecutableTestUtil::TestStatus Test8_PartialReads_AssembleWholeCommand();
+    static ExecutableTestUtil::TestStatus Test9_PipelinedCommands_EachHandled();
+    static ExecutableTestUtil::TestStatus Test10_ConnectionChurn_ReusesHandlerFrames();
+    static ExecutableTestUtil::TestStatus Test11_IdlePass_ReportsNoWork();
+    static ExecutableTestUtil::TestStatus Test12_OverlongLine_RejectedNotSplit();
+    static ExecutableTestUtil::TestStatus Test13_WriteBlockedClientSending_ReportsNoWork();
+    static ExecutableTestUtil::TestStatus Test14_BacklogDuringBroadcasts_DeliveredWholeAndInOrder();
+};
+
+}
+
+#endif /* CONNECTIONMANAGERTEST_HPP_ */
@@ -19,6 +19,10 @@ void CountAPITest::runTests(){
     m_testResults.push_back(CountAPITest::Test4_HandleCommand_DECR_UnexpectedInput());
     m_testResults.push_back(CountAPITest::Test5_HandleCommand_OUTPUT());
     m_testResults.push_back(CountAPITest::Test6_HandleCommand_INVALID());
+    m_testResults.push_back(CountAPITest::Test7_HandleCommand_BATCH_ExpectedInput());
+    m_testResults.push_back(CountAPITest::Test8_HandleCommand_BATCH_UnexpectedInput());
+    m_testResults.push_back(CountAPITest::Test9_HandleCommand_BATCH_OutOfRange());
+    m_testResults.push_back(CountAPITest::Test10_HandleCommand_INCR_DECR_ReplyIsOneLine());
     //DO LAST:
     evaluateTests();
 }
@@ -129,4 +133,87 @@ ExecutableTestUtil::TestStatus CountAPITest::Test6_HandleCommand_INVALID(){
     return ExecutableTestUtil::TestStatus::PASSED;
 }
 
-}
\ No newline at end of file
+ExecutableTestUtil::TestStatus CountAPITest::Test7_HandleCommand_BATCH_ExpectedInput(){
+    std::cout << "Starting Test7_HandleCommand_BATCH_ExpectedInput..." << std::endl;
+    
+    CountAPI api;
+    std::string output = "";
+    std::string input = "BATCH INCR 5 DECR 2 INCR 7\r\n"; //Input Command Under Test
+
+    if(api.handleInCommand(input, output) != CountAPI::InputCommand::BATCH){
+        std::cerr << "Test7: FAIL - Did not determine correct InputCommand." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(api.getCount() != 10){
+        std::cerr << "Test7: FAIL - Did not apply batch net delta correctly." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test7: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus CountAPITest::Test8_HandleCommand_BATCH_UnexpectedInput(){
+    std::cout << "Starting Test8_HandleCommand_BATCH_UnexpectedInput..." << std::endl;
+    
+    CountAPI api;
+    std::string output = "";
+    std::string input = "BATCH INCR 5 DECR abc INCR 7\r\n"; //Input Command Under Test
+
+    if(api.handleInCommand(input, output) != CountAPI::InputCommand::INVALID){
+        std::cerr << "Test8: FAIL - Did not determine correct InputCommand." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(api.getCount() != 0){
+        std::cerr << "Test8: FAIL - Partially applied an invalid batch." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test8: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus CountAPITest::Test9_HandleCommand_BATCH_OutOfRange(){
+    std::cout << "Starting Test9_HandleCommand_BATCH_OutOfRange..." << std::endl;
+    
+    CountAPI api;
+    std::string output = "";
+    std::string input = "BATCH INCR 2147483647 INCR 2147483647\r\n"; //Input Command Under Test
+
+    if(api.handleInCommand(input, output) != CountAPI::InputCommand::INVALID){
+        std::cerr << "Test9: FAIL - Did not determine correct InputCommand." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(api.getCount() != 0){
+        std::cerr << "Test9: FAIL - Applied a batch that overflows the count." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test9: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus CountAPITest::Test10_HandleCommand_INCR_DECR_ReplyIsOneLine(){
+    std::cout << "Starting Test10_HandleCommand_INCR_DECR_ReplyIsOneLine..." << std::endl;
+    
+    CountAPI api;
+    std::string incrOutput = "";
+    std::string decrOutput = "";
+    std::string incrInput = "INCR 5\r\n"; //Input Command Under Test
+    std::string decrInput = "DECR 2\r\n"; //Input Command Under Test
+    api.handleInCommand(incrInput, incrOutput);
+    api.handleInCommand(decrInput, decrOutput);
+
+    if(incrOutput != "Increased by 5 (Current Count: 5)\r\n" || decrOutput != "Decreased by 2 (Current Count: 3)\r\n"){
+        std::cerr << "Test10: FAIL - Reply was not a single line: '" << incrOutput << "' '" << decrOutput << "'" << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test10: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+}
@@ -21,6 +21,10 @@ private:
     static ExecutableTestUtil::TestStatus Test4_HandleCommand_DECR_UnexpectedInput();
     static ExecutableTestUtil::TestStatus Test5_HandleCommand_OUTPUT();
     static ExecutableTestUtil::TestStatus Test6_HandleCommand_INVALID();
+    static ExecutableTestUtil::TestStatus Test7_HandleCommand_BATCH_ExpectedInput();
+    static ExecutableTestUtil::TestStatus Test8_HandleCommand_BATCH_UnexpectedInput();
+    static ExecutableTestUtil::TestStatus Test9_HandleCommand_BATCH_OutOfRange();
+    static ExecutableTestUtil::TestStatus Test10_HandleCommand_INCR_DECR_ReplyIsOneLine();
 };
 
 }
@@ -0,0 +1,112 @@
+#include "ServerConfigTest.hpp"
+#include "../src/utils/ServerConfig.hpp"
+#include <iostream>
+#include <string>
+#include <stdio.h>
+
+int main() {
+    linuxservice::ServerConfigTest testSet;
+    testSet.runTests();
+    return 0;
+}
+
+namespace linuxservice {
+
+void ServerConfigTest::runTests(){
+    //Add tests here:
+    m_testResults.push_back(ServerConfigTest::Test1_ParseArgs_PortAndCaptureFile());
+    m_testResults.push_back(ServerConfigTest::Test2_ParseArgs_NoPort());
+    m_testResults.push_back(ServerConfigTest::Test3_ParseArgs_OptionsOverrideConfigFile());
+    m_testResults.push_back(ServerConfigTest::Test4_Set_UnexpectedInput());
+    //DO LAST:
+    evaluateTests();
+}
+
+ExecutableTestUtil::TestStatus ServerConfigTest::Test1_ParseArgs_PortAndCaptureFile(){
+    std::cout << "Starting Test1_ParseArgs_PortAndCaptureFile..." << std::endl;
+    
+    ServerConfig config;
+    char const *argv[] = {"SingleCurrentCtLinuxService", "8089", "traffic.cap"}; //Input Under Test
+
+    if(!config.parseArgs(3, argv)){
+        std::cerr << "Test1: FAIL - Rejected the original command line." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(config.port != 8089 || config.captureFile != "traffic.cap" 
+        || config.backlog != 1024 || config.maxConnections != 1024){
+        std::cerr << "Test1: FAIL - Did not keep the spec defaults." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test1: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ServerConfigTest::Test2_ParseArgs_NoPort(){
+    std::cout << "Starting Test2_ParseArgs_NoPort..." << std::endl;
+    
+    ServerConfig config;
+    char const *argv[] = {"SingleCurrentCtLinuxService", "--tcp-nodelay=true"}; //Input Under Test
+
+    if(config.parseArgs(2, argv)){
+        std::cerr << "Test2: FAIL - Accepted a command line without a port." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test2: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ServerConfigTest::Test3_ParseArgs_OptionsOverrideConfigFile(){
+    std::cout << "Starting Test3_ParseArgs_OptionsOverrideConfigFile..." << std::endl;
+    
+    std::string path = "ServerConfigTest_Test3.conf";
+    FILE* pFile = fopen(path.c_str(), "w");
+    fputs("# low latency profile\n"
+          "port = 9000\n"
+          "wait_strategy = busy_poll\n"
+          "tcp_nodelay = true\n"
+          "max_connections = 20000   # trailing comment\n", pFile);
+    fclose(pFile);
+
+    ServerConfig config;
+    char const *argv[] = {"SingleCurrentCtLinuxService", "--wait-strategy=adaptive", "--config", path.c_str()}; //Input Under Test
+    bool parsed = config.parseArgs(4, argv);
+    remove(path.c_str());
+
+    if(!parsed){
+        std::cerr << "Test3: FAIL - Rejected a valid config file." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(config.port != 9000 || !config.tcpNoDelay || config.maxConnections != 20000){
+        std::cerr << "Test3: FAIL - Did not apply the config file." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(config.waitStrategy != ServerConfig::ADAPTIVE){
+        std::cerr << "Test3: FAIL - Command line option did not override the config file." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test3: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus ServerConfigTest::Test4_Set_UnexpectedInput(){
+    std::cout << "Starting Test4_Set_UnexpectedInput..." << std::endl;
+    
+    ServerConfig config;
+
+    if(config.set("wait_strategy", "sometimes") || config.set("backlog", "0") 
+        || config.set("send_buffer_bytes", "64k") || config.set("no_such_setting", "1")){
+        std::cerr << "Test4: FAIL - Accepted an invalid setting." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test4: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+}
@@ -0,0 +1,26 @@
+#ifndef SERVERCONFIGTEST_HPP_
+#define SERVERCONFIGTEST_HPP_
+
+#include "utils/ExecutableTestUtil.hpp"
+
+namespace linuxservice {
+
+class ServerConfigTest : public ExecutableTestUtil {
+public:
+	ServerConfigTest() = default;
+	~ServerConfigTest() = default;
+	ServerConfigTest(const ServerConfigTest&) = delete;
+	ServerConfigTest& operator=(const ServerConfigTest&) = delete;
+
+	void runTests();
+
+private:
+	static ExecutableTestUtil::TestStatus Test1_ParseArgs_PortAndCaptureFile();
+    static ExecutableTestUtil::TestStatus Test2_ParseArgs_NoPort();
+	static ExecutableTestUtil::TestStatus Test3_ParseArgs_OptionsOverrideConfigFile();
+    static ExecutableTestUtil::TestStatus Test4_Set_UnexpectedInput();
+};
+
+}
+
+#endif /* SERVERCONFIGTEST_HPP_ */
@@ -0,0 +1,128 @@
+#include "TrafficCaptureTest.hpp"
+#include "../src/utils/ConnectionManager.hpp"
+#include "../src/utils/CountAPI.hpp"
+#include "../src/utils/LoopbackTransport.hpp"
+#include "../src/utils/TrafficCapture.hpp"
+#include <iostream>
+#include <string>
+#include <stdio.h>
+
+int main() {
+    linuxservice::TrafficCaptureTest testSet;
+    testSet.runTests();
+    return 0;
+}
+
+namespace linuxservice {
+
+void TrafficCaptureTest::runTests(){
+    //Add tests here:
+    m_testResults.push_back(TrafficCaptureTest::Test1_RecordAndRead_RoundTrip());
+    m_testResults.push_back(TrafficCaptureTest::Test2_ReadCapture_NotACaptureFile());
+    m_testResults.push_back(TrafficCaptureTest::Test3_ConnectionManager_RecordsQuietConnections());
+    //DO LAST:
+    evaluateTests();
+}
+
+ExecutableTestUtil::TestStatus TrafficCaptureTest::Test1_RecordAndRead_RoundTrip(){
+    std::cout << "Starting Test1_RecordAndRead_RoundTrip..." << std::endl;
+    
+    std::string path = "TrafficCaptureTest_Test1.cap";
+    std::string first = "INCR 5\r\n";
+    std::string second = "OUTPUT\r\n";
+    {
+        //capture is flushed and closed when it goes out of scope
+        TrafficCapture capture(path);
+        capture.record(0, first.data(), first.size());
+        capture.record(7, second.data(), second.size());
+        capture.recordEvent(7, TrafficCapture::CLOSE);
+    }
+
+    std::vector<TrafficCapture::Record> records;
+    bool readOk = TrafficCapture::readCapture(path, records);
+    remove(path.c_str());
+
+    if(!readOk || records.size() != 3){
+        std::cerr << "Test1: FAIL - Did not read back every record." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(records[0].connectionId != 0 || records[0].type != TrafficCapture::DATA || records[0].data != first 
+        || records[1].connectionId != 7 || records[1].type != TrafficCapture::DATA || records[1].data != second
+        || records[2].connectionId != 7 || records[2].type != TrafficCapture::CLOSE || !records[2].data.empty()){
+        std::cerr << "Test1: FAIL - Record contents did not round trip." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    if(records[1].timestampNs < records[0].timestampNs){
+        std::cerr << "Test1: FAIL - Timestamps went backwards." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test1: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus TrafficCaptureTest::Test2_ReadCapture_NotACaptureFile(){
+    std::cout << "Starting Test2_ReadCapture_NotACaptureFile..." << std::endl;
+    
+    std::string path = "TrafficCaptureTest_Test2.cap";
+    FILE* pFile = fopen(path.c_str(), "wb");
+    fputs("INCR 5\r\n", pFile);
+    fclose(pFile);
+
+    std::vector<TrafficCapture::Record> records;
+    bool readOk = TrafficCapture::readCapture(path, records);
+    remove(path.c_str());
+
+    if(readOk || !records.empty()){
+        std::cerr << "Test2: FAIL - Accepted a file without the capture header." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test2: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+ExecutableTestUtil::TestStatus TrafficCaptureTest::Test3_ConnectionManager_RecordsQuietConnections(){
+    std::cout << "Starting Test3_ConnectionManager_RecordsQuietConnections..." << std::endl;
+    
+    std::string path = "TrafficCaptureTest_Test3.cap";
+    {
+        std::shared_ptr<LoopbackTransport> pTransport(new LoopbackTransport());
+        ConnectionManager manager(pTransport, std::shared_ptr<API>(new CountAPI()));
+        manager.setTrafficCapture(std::shared_ptr<TrafficCapture>(new TrafficCapture(path)));
+        int sender = pTransport->connectClient();
+        int subscriber = pTransport->connectClient();
+        manager.handleConnections();
+        manager.handleConnections();
+
+        pTransport->clientSend(sender, "INCR 5\r\n"); //Input Command Under Test
+        pTransport->clientClose(subscriber);
+        manager.handleConnections();
+        manager.handleConnections();
+    }
+
+    std::vector<TrafficCapture::Record> records;
+    bool readOk = TrafficCapture::readCapture(path, records);
+    remove(path.c_str());
+
+    int accepts = 0;
+    int closes = 0;
+    int reads = 0;
+    for(size_t i = 0; i < records.size(); i++){
+        accepts += (records[i].type == TrafficCapture::ACCEPT);
+        closes += (records[i].type == TrafficCapture::CLOSE);
+        reads += (records[i].type == TrafficCapture::DATA);
+    }
+    if(!readOk || accepts != 2 || closes != 1 || reads != 1){
+        std::cerr << "Test3: FAIL - Expected 2 accepts, 1 close and 1 read, got " << accepts << ", " 
+            << closes << " and " << reads << "." << std::endl;
+        return ExecutableTestUtil::TestStatus::FAILED;
+    }
+
+    std::cout << "Test3: PASS" << std::endl;
+    return ExecutableTestUtil::TestStatus::PASSED;
+}
+
+}
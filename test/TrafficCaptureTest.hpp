@@ -0,0 +1,25 @@
+#ifndef TRAFFICCAPTURETEST_HPP_
+#define TRAFFICCAPTURETEST_HPP_
+
+#include "utils/ExecutableTestUtil.hpp"
+
+namespace linuxservice {
+
+class TrafficCaptureTest : public ExecutableTestUtil {
+public:
+	TrafficCaptureTest() = default;
+	~TrafficCaptureTest() = default;
+	TrafficCaptureTest(const TrafficCaptureTest&) = delete;
+	TrafficCaptureTest& operator=(const TrafficCaptureTest&) = delete;
+
+	void runTests();
+
+private:
+	static ExecutableTestUtil::TestStatus Test1_RecordAndRead_RoundTrip();
+    static ExecutableTestUtil::TestStatus Test2_ReadCapture_NotACaptureFile();
+    static ExecutableTestUtil::TestStatus Test3_ConnectionManager_RecordsQuietConnections();
+};
+
+}
+
+#endif /* TRAFFICCAPTURETEST_HPP_ */